@@ -0,0 +1,116 @@
+#pragma once
+
+#include "csr_graph.h"
+#include "router.h"
+
+#include <functional>
+#include <limits>
+#include <queue>
+
+namespace graph {
+
+// Ищет кратчайший путь по запросу алгоритмом A*: вершины извлекаются из очереди
+// по сумме веса пути и нижней оценки оставшегося веса до цели. Оценка должна
+// быть допустимой (не больше веса кратчайшего пути), иначе маршрут может оказаться не кратчайшим
+template <typename Weight>
+class AStarRouter : public RoutingEngine<Weight> {
+private:
+    using Graph = DirectedWeightedGraph<Weight>;
+
+public:
+    using RouteInfo = typename RoutingEngine<Weight>::RouteInfo;
+    // Нижняя оценка веса пути из vertex в to
+    using Heuristic = std::function<Weight(VertexId vertex, VertexId to)>;
+
+    // csr_graph — тот же граф в формате CSR, по которому идёт поиск; движок хранит ссылки на оба графа
+    AStarRouter(const Graph& graph, const CsrGraph<Weight>& csr_graph, Heuristic heuristic);
+
+    std::optional<RouteInfo> BuildRoute(VertexId from, VertexId to) const override;
+
+    std::optional<RouteInfo> BuildRouteWithStats(VertexId from, VertexId to, SearchStats& stats) const override;
+
+private:
+    using QueueItem = std::pair<Weight, VertexId>;
+
+    static constexpr Weight ZERO_WEIGHT{};
+    static constexpr EdgeId NO_EDGE = std::numeric_limits<EdgeId>::max();
+    const Graph& graph_;
+    const CsrGraph<Weight>& csr_graph_;
+    Heuristic heuristic_;
+};
+
+template <typename Weight>
+AStarRouter<Weight>::AStarRouter(const Graph& graph, const CsrGraph<Weight>& csr_graph, Heuristic heuristic)
+    : graph_(graph)
+    , csr_graph_(csr_graph)
+    , heuristic_(std::move(heuristic))
+{
+    for (EdgeId edge_id = 0; edge_id < graph.GetEdgeCount(); ++edge_id) {
+        if (graph.GetEdge(edge_id).weight < ZERO_WEIGHT) {
+            throw std::domain_error("Edges' weights should be non-negative");
+        }
+    }
+}
+
+template <typename Weight>
+std::optional<typename AStarRouter<Weight>::RouteInfo> AStarRouter<Weight>::BuildRoute(VertexId from, VertexId to) const {
+    SearchStats stats;
+    return BuildRouteWithStats(from, to, stats);
+}
+
+template <typename Weight>
+std::optional<typename AStarRouter<Weight>::RouteInfo>
+AStarRouter<Weight>::BuildRouteWithStats(VertexId from, VertexId to, SearchStats& stats) const {
+    stats = {};
+    const size_t vertex_count = graph_.GetVertexCount();
+    if (from >= vertex_count || to >= vertex_count) {
+        throw std::out_of_range("Vertex id is out of range");
+    }
+
+    std::vector<std::optional<Weight>> weights(vertex_count);
+    // Оценка для вершины вычисляется один раз за запрос
+    std::vector<std::optional<Weight>> estimates(vertex_count);
+    std::vector<EdgeId> prev_edges(vertex_count, NO_EDGE);
+    std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>> queue;
+
+    weights[from] = ZERO_WEIGHT;
+    estimates[from] = heuristic_(from, to);
+    queue.push({*estimates[from], from});
+    while (!queue.empty()) {
+        const auto [priority, vertex] = queue.top();
+        queue.pop();
+        const Weight weight = *weights[vertex];
+        if (priority > weight + *estimates[vertex]) {
+            continue;
+        }
+        ++stats.settled_vertices;
+        if (vertex == to) {
+            break;
+        }
+        for (size_t arc = csr_graph_.GetArcsBegin(vertex); arc < csr_graph_.GetArcsEnd(vertex); ++arc) {
+            const VertexId next_vertex = csr_graph_.GetTarget(arc);
+            const Weight candidate_weight = weight + csr_graph_.GetWeight(arc);
+            if (!weights[next_vertex] || candidate_weight < *weights[next_vertex]) {
+                if (!estimates[next_vertex]) {
+                    estimates[next_vertex] = heuristic_(next_vertex, to);
+                }
+                weights[next_vertex] = candidate_weight;
+                prev_edges[next_vertex] = csr_graph_.GetEdgeId(arc);
+                queue.push({candidate_weight + *estimates[next_vertex], next_vertex});
+            }
+        }
+    }
+
+    if (!weights[to]) {
+        return std::nullopt;
+    }
+    std::vector<EdgeId> edges;
+    for (EdgeId edge_id = prev_edges[to]; edge_id != NO_EDGE; edge_id = prev_edges[graph_.GetEdge(edge_id).from]) {
+        edges.push_back(edge_id);
+    }
+    std::reverse(edges.begin(), edges.end());
+
+    return RouteInfo{*weights[to], std::move(edges)};
+}
+
+}  // namespace graph
@@ -0,0 +1,579 @@
+#pragma once
+
+#include "csr_graph.h"
+#include "router.h"
+
+#include <functional>
+#include <queue>
+
+namespace graph {
+
+// Иерархия сжатия (Contraction Hierarchies): вершины поочерёдно стягиваются,
+// а кратчайшие пути через стянутую вершину заменяются составными рёбрами.
+// Запрос — двунаправленный поиск Дейкстры только вверх по иерархии, после которого
+// составные рёбра раскрываются обратно в рёбра исходного графа.
+// Память линейна по размеру графа с учётом добавленных составных рёбер
+template <typename Weight>
+class ContractionHierarchy : public RoutingEngine<Weight> {
+private:
+    using Graph = DirectedWeightedGraph<Weight>;
+
+public:
+    using RouteInfo = typename RoutingEngine<Weight>::RouteInfo;
+
+    // Составное ребро заменяет пару дуг first -> second. Дуги нумеруются сквозным образом:
+    // номер меньше числа рёбер графа — исходное ребро, иначе — составное ребро с индексом
+    // (номер - число рёбер графа)
+    struct Shortcut {
+        VertexId from;
+        VertexId to;
+        Weight weight;
+        EdgeId first;
+        EdgeId second;
+    };
+
+    struct HierarchyData {
+        // Порядок стягивания вершины: чем больше, тем выше вершина в иерархии
+        std::vector<uint32_t> ranks;
+        std::vector<Shortcut> shortcuts;
+    };
+
+    explicit ContractionHierarchy(const Graph& graph);
+
+    // Восстанавливает иерархию, ранее построенную по тому же графу
+    ContractionHierarchy(const Graph& graph, HierarchyData hierarchy_data);
+
+    std::optional<RouteInfo> BuildRoute(VertexId from, VertexId to) const override;
+
+    std::optional<RouteInfo> BuildRouteWithStats(VertexId from, VertexId to, SearchStats& stats) const override;
+
+    // Прямой поиск вверх из from выполняется один раз, для каждой цели — только обратный поиск;
+    // без with_edges составные рёбра не раскрываются
+    std::vector<std::optional<RouteInfo>> BuildRoutesFrom(VertexId from, const std::vector<VertexId>& targets,
+                                                          bool with_edges) const override;
+
+    // Веса маршрутов между всеми парами sources × targets корзинным алгоритмом: обратные поиски из целей
+    // раскладывают веса по корзинам вершин, после чего прямой поиск из каждого источника просматривает
+    // корзины достигнутых вершин. Каждая цель и каждый источник обходятся один раз
+    std::vector<std::vector<std::optional<Weight>>> BuildWeightMatrix(const std::vector<VertexId>& sources,
+                                                                      const std::vector<VertexId>& targets) const;
+
+    const HierarchyData& GetHierarchyData() const;
+
+private:
+    struct ArcInfo {
+        VertexId from;
+        VertexId to;
+        Weight weight;
+    };
+
+    using QueueItem = std::pair<Weight, VertexId>;
+    using MinQueue = std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>>;
+
+    static constexpr Weight ZERO_WEIGHT{};
+    static constexpr Weight INFINITE_WEIGHT = std::numeric_limits<Weight>::max();
+    static constexpr EdgeId NO_ARC = std::numeric_limits<EdgeId>::max();
+    // Поиск свидетеля ограничен, чтобы предобработка не вырождалась в полный Дейкстру;
+    // не найденный свидетель лишь добавляет лишнее составное ребро
+    static constexpr size_t WITNESS_SETTLED_LIMIT = 50;
+
+    ArcInfo GetArc(EdgeId arc_id) const {
+        if (arc_id < graph_.GetEdgeCount()) {
+            const auto& edge = graph_.GetEdge(arc_id);
+            return {edge.from, edge.to, edge.weight};
+        }
+        const Shortcut& shortcut = hierarchy_data_.shortcuts[arc_id - graph_.GetEdgeCount()];
+        return {shortcut.from, shortcut.to, shortcut.weight};
+    }
+
+    class Contractor;
+
+    // Веса и последние дуги поиска вверх по иерархии; reached — вершины с конечным весом для сброса
+    struct SearchSpace {
+        std::vector<Weight> weights;
+        std::vector<EdgeId> prev_arcs;
+        std::vector<VertexId> reached;
+
+        explicit SearchSpace(size_t vertex_count)
+            : weights(vertex_count, INFINITE_WEIGHT)
+            , prev_arcs(vertex_count, NO_ARC) {}
+
+        void Reset() {
+            for (const VertexId vertex : reached) {
+                weights[vertex] = INFINITE_WEIGHT;
+                prev_arcs[vertex] = NO_ARC;
+            }
+            reached.clear();
+        }
+    };
+
+    void BuildSearchGraphs();
+
+    void CheckVertex(VertexId vertex) const;
+
+    // Дейкстра вверх по иерархии из start: direction 0 — по прямым дугам, 1 — по развёрнутым.
+    // Для каждой вершины с окончательным весом вызывается settle(vertex, weight); поиск заканчивается,
+    // когда очередь пуста или её наименьший вес не меньше bound()
+    template <typename Settle, typename Bound>
+    void SearchUpward(int direction, VertexId start, SearchSpace& space, Settle settle, Bound bound) const;
+
+    // Рёбра исходного графа на пути через meeting_vertex по дугам прямого и обратного поисков
+    std::vector<EdgeId> RestoreEdges(VertexId meeting_vertex, const std::vector<EdgeId>& forward_prev_arcs,
+                                     const std::vector<EdgeId>& backward_prev_arcs) const;
+
+    void UnpackArc(EdgeId arc_id, std::vector<EdgeId>& edges) const;
+
+    const Graph& graph_;
+    HierarchyData hierarchy_data_;
+    // Дуги из вершины в более высокие вершины для прямого поиска и развёрнутые дуги
+    // из более высоких вершин для обратного; номер ребра дуги — сквозной номер
+    CsrGraph<Weight> search_graphs_[2];
+};
+
+// Стягивает вершины в порядке приоритета «разность рёбер + число стянутых соседей»
+// с ленивым пересчётом приоритетов
+template <typename Weight>
+class ContractionHierarchy<Weight>::Contractor {
+public:
+    explicit Contractor(ContractionHierarchy& hierarchy)
+        : hierarchy_(hierarchy)
+        , vertex_count_(hierarchy.graph_.GetVertexCount())
+        , out_arcs_(vertex_count_)
+        , in_arcs_(vertex_count_)
+        , contracted_(vertex_count_, false)
+        , contracted_neighbors_(vertex_count_, 0)
+        , witness_weights_(vertex_count_, INFINITE_WEIGHT)
+    {
+        const Graph& graph = hierarchy.graph_;
+        for (EdgeId edge_id = 0; edge_id < graph.GetEdgeCount(); ++edge_id) {
+            const auto& edge = graph.GetEdge(edge_id);
+            if (edge.weight < ZERO_WEIGHT) {
+                throw std::domain_error("Edges' weights should be non-negative");
+            }
+            if (edge.from != edge.to) {
+                out_arcs_[edge.from].push_back(edge_id);
+                in_arcs_[edge.to].push_back(edge_id);
+            }
+        }
+    }
+
+    void Contract() {
+        std::priority_queue<std::pair<long long, VertexId>,
+                            std::vector<std::pair<long long, VertexId>>,
+                            std::greater<std::pair<long long, VertexId>>> queue;
+        std::vector<Shortcut> shortcuts;
+        for (VertexId vertex = 0; vertex < vertex_count_; ++vertex) {
+            queue.push({ComputePriority(vertex, shortcuts), vertex});
+        }
+        hierarchy_.hierarchy_data_.ranks.assign(vertex_count_, 0);
+        uint32_t rank = 0;
+        while (!queue.empty()) {
+            const VertexId vertex = queue.top().second;
+            queue.pop();
+            if (contracted_[vertex]) {
+                continue;
+            }
+            // Составные рёбра, найденные при пересчёте приоритета, сразу используются для стягивания
+            const long long priority = ComputePriority(vertex, shortcuts);
+            if (!queue.empty() && priority > queue.top().first) {
+                queue.push({priority, vertex});
+                continue;
+            }
+            for (const Shortcut& shortcut : shortcuts) {
+                const EdgeId arc_id = hierarchy_.graph_.GetEdgeCount() + hierarchy_.hierarchy_data_.shortcuts.size();
+                hierarchy_.hierarchy_data_.shortcuts.push_back(shortcut);
+                out_arcs_[shortcut.from].push_back(arc_id);
+                in_arcs_[shortcut.to].push_back(arc_id);
+            }
+            contracted_[vertex] = true;
+            hierarchy_.hierarchy_data_.ranks[vertex] = rank++;
+            for (const EdgeId arc_id : out_arcs_[vertex]) {
+                ++contracted_neighbors_[hierarchy_.GetArc(arc_id).to];
+            }
+            for (const EdgeId arc_id : in_arcs_[vertex]) {
+                ++contracted_neighbors_[hierarchy_.GetArc(arc_id).from];
+            }
+            out_arcs_[vertex].clear();
+            in_arcs_[vertex].clear();
+        }
+    }
+
+private:
+    long long ComputePriority(VertexId vertex, std::vector<Shortcut>& shortcuts) {
+        shortcuts.clear();
+        FindShortcuts(vertex, shortcuts);
+        const size_t shortcut_count = shortcuts.size();
+        const size_t degree = CountAliveArcs(out_arcs_[vertex], true) + CountAliveArcs(in_arcs_[vertex], false);
+        return static_cast<long long>(shortcut_count) - static_cast<long long>(degree)
+            + static_cast<long long>(contracted_neighbors_[vertex]);
+    }
+
+    size_t CountAliveArcs(const std::vector<EdgeId>& arcs, bool outgoing) const {
+        return std::count_if(arcs.begin(), arcs.end(), [this, outgoing](EdgeId arc_id) {
+            const ArcInfo arc = hierarchy_.GetArc(arc_id);
+            return !contracted_[outgoing ? arc.to : arc.from];
+        });
+    }
+
+    // Для каждой вершины оставляет самую лёгкую дугу к ней среди ещё не стянутых
+    std::vector<std::pair<VertexId, std::pair<Weight, EdgeId>>> GetLightestArcs(VertexId vertex, bool outgoing) const {
+        std::vector<std::pair<VertexId, std::pair<Weight, EdgeId>>> arcs;
+        for (const EdgeId arc_id : outgoing ? out_arcs_[vertex] : in_arcs_[vertex]) {
+            const ArcInfo arc = hierarchy_.GetArc(arc_id);
+            const VertexId neighbor = outgoing ? arc.to : arc.from;
+            if (!contracted_[neighbor]) {
+                arcs.push_back({neighbor, {arc.weight, arc_id}});
+            }
+        }
+        std::sort(arcs.begin(), arcs.end());
+        arcs.erase(std::unique(arcs.begin(), arcs.end(),
+                               [](const auto& lhs, const auto& rhs) { return lhs.first == rhs.first; }),
+                   arcs.end());
+        return arcs;
+    }
+
+    // Находит составные рёбра, необходимые при стягивании вершины
+    void FindShortcuts(VertexId vertex, std::vector<Shortcut>& shortcuts) {
+        const auto in_arcs = GetLightestArcs(vertex, false);
+        const auto out_arcs = GetLightestArcs(vertex, true);
+        if (in_arcs.empty() || out_arcs.empty()) {
+            return;
+        }
+        Weight max_out_weight = ZERO_WEIGHT;
+        for (const auto& [to, out_arc] : out_arcs) {
+            max_out_weight = std::max(max_out_weight, out_arc.first);
+        }
+        for (const auto& [from, in_arc] : in_arcs) {
+            RunWitnessSearch(from, vertex, in_arc.first + max_out_weight);
+            for (const auto& [to, out_arc] : out_arcs) {
+                if (to == from) {
+                    continue;
+                }
+                const Weight shortcut_weight = in_arc.first + out_arc.first;
+                if (witness_weights_[to] <= shortcut_weight) {
+                    continue;
+                }
+                shortcuts.push_back({from, to, shortcut_weight, in_arc.second, out_arc.second});
+            }
+            ResetWitnessSearch();
+        }
+    }
+
+    // Дейкстра по ещё не стянутым вершинам в обход excluded_vertex до веса max_weight
+    void RunWitnessSearch(VertexId from, VertexId excluded_vertex, Weight max_weight) {
+        MinQueue queue;
+        witness_weights_[from] = ZERO_WEIGHT;
+        touched_.push_back(from);
+        queue.push({ZERO_WEIGHT, from});
+        size_t settled_count = 0;
+        while (!queue.empty() && settled_count < WITNESS_SETTLED_LIMIT) {
+            const auto [weight, vertex] = queue.top();
+            queue.pop();
+            if (weight > witness_weights_[vertex]) {
+                continue;
+            }
+            if (weight > max_weight) {
+                break;
+            }
+            ++settled_count;
+            for (const EdgeId arc_id : out_arcs_[vertex]) {
+                const ArcInfo arc = hierarchy_.GetArc(arc_id);
+                if (arc.to == excluded_vertex || contracted_[arc.to]) {
+                    continue;
+                }
+                const Weight candidate_weight = weight + arc.weight;
+                if (candidate_weight < witness_weights_[arc.to]) {
+                    if (witness_weights_[arc.to] == INFINITE_WEIGHT) {
+                        touched_.push_back(arc.to);
+                    }
+                    witness_weights_[arc.to] = candidate_weight;
+                    queue.push({candidate_weight, arc.to});
+                }
+            }
+        }
+    }
+
+    void ResetWitnessSearch() {
+        for (const VertexId vertex : touched_) {
+            witness_weights_[vertex] = INFINITE_WEIGHT;
+        }
+        touched_.clear();
+    }
+
+    ContractionHierarchy& hierarchy_;
+    const size_t vertex_count_;
+    std::vector<std::vector<EdgeId>> out_arcs_;
+    std::vector<std::vector<EdgeId>> in_arcs_;
+    std::vector<bool> contracted_;
+    std::vector<size_t> contracted_neighbors_;
+    std::vector<Weight> witness_weights_;
+    std::vector<VertexId> touched_;
+};
+
+template <typename Weight>
+ContractionHierarchy<Weight>::ContractionHierarchy(const Graph& graph)
+    : graph_(graph)
+{
+    Contractor(*this).Contract();
+    BuildSearchGraphs();
+}
+
+template <typename Weight>
+ContractionHierarchy<Weight>::ContractionHierarchy(const Graph& graph, HierarchyData hierarchy_data)
+    : graph_(graph)
+    , hierarchy_data_(std::move(hierarchy_data))
+{
+    if (hierarchy_data_.ranks.size() != graph.GetVertexCount()) {
+        throw std::invalid_argument("Hierarchy data doesn't match the graph");
+    }
+    const size_t arc_count = graph.GetEdgeCount() + hierarchy_data_.shortcuts.size();
+    for (const Shortcut& shortcut : hierarchy_data_.shortcuts) {
+        if (shortcut.first >= arc_count || shortcut.second >= arc_count) {
+            throw std::invalid_argument("Hierarchy data doesn't match the graph");
+        }
+    }
+    BuildSearchGraphs();
+}
+
+template <typename Weight>
+const typename ContractionHierarchy<Weight>::HierarchyData& ContractionHierarchy<Weight>::GetHierarchyData() const {
+    return hierarchy_data_;
+}
+
+template <typename Weight>
+void ContractionHierarchy<Weight>::BuildSearchGraphs() {
+    const size_t arc_count = graph_.GetEdgeCount() + hierarchy_data_.shortcuts.size();
+    const auto& ranks = hierarchy_data_.ranks;
+    std::vector<typename CsrGraph<Weight>::Arc> upward_arcs;
+    std::vector<typename CsrGraph<Weight>::Arc> downward_arcs;
+    for (EdgeId arc_id = 0; arc_id < arc_count; ++arc_id) {
+        const ArcInfo arc = GetArc(arc_id);
+        if (ranks[arc.from] < ranks[arc.to]) {
+            upward_arcs.push_back({arc.from, arc.to, arc.weight, arc_id});
+        } else if (ranks[arc.from] > ranks[arc.to]) {
+            downward_arcs.push_back({arc.to, arc.from, arc.weight, arc_id});
+        }
+    }
+    search_graphs_[0] = CsrGraph<Weight>(graph_.GetVertexCount(), upward_arcs);
+    search_graphs_[1] = CsrGraph<Weight>(graph_.GetVertexCount(), downward_arcs);
+}
+
+template <typename Weight>
+void ContractionHierarchy<Weight>::UnpackArc(EdgeId arc_id, std::vector<EdgeId>& edges) const {
+    std::vector<EdgeId> stack{arc_id};
+    while (!stack.empty()) {
+        const EdgeId current = stack.back();
+        stack.pop_back();
+        if (current < graph_.GetEdgeCount()) {
+            edges.push_back(current);
+            continue;
+        }
+        const Shortcut& shortcut = hierarchy_data_.shortcuts[current - graph_.GetEdgeCount()];
+        stack.push_back(shortcut.second);
+        stack.push_back(shortcut.first);
+    }
+}
+
+template <typename Weight>
+std::optional<typename ContractionHierarchy<Weight>::RouteInfo> ContractionHierarchy<Weight>::BuildRoute(VertexId from,
+                                                                                                         VertexId to) const {
+    SearchStats stats;
+    return BuildRouteWithStats(from, to, stats);
+}
+
+template <typename Weight>
+std::optional<typename ContractionHierarchy<Weight>::RouteInfo>
+ContractionHierarchy<Weight>::BuildRouteWithStats(VertexId from, VertexId to, SearchStats& stats) const {
+    stats = {};
+    const size_t vertex_count = graph_.GetVertexCount();
+    if (from >= vertex_count || to >= vertex_count) {
+        throw std::out_of_range("Vertex id is out of range");
+    }
+
+    // Индекс 0 — прямой поиск из from, индекс 1 — обратный поиск из to
+    std::vector<Weight> weights[2] = {std::vector<Weight>(vertex_count, INFINITE_WEIGHT),
+                                      std::vector<Weight>(vertex_count, INFINITE_WEIGHT)};
+    std::vector<EdgeId> prev_arcs[2] = {std::vector<EdgeId>(vertex_count, NO_ARC),
+                                        std::vector<EdgeId>(vertex_count, NO_ARC)};
+    MinQueue queues[2];
+    weights[0][from] = ZERO_WEIGHT;
+    weights[1][to] = ZERO_WEIGHT;
+    queues[0].push({ZERO_WEIGHT, from});
+    queues[1].push({ZERO_WEIGHT, to});
+
+    Weight best_weight = INFINITE_WEIGHT;
+    VertexId meeting_vertex = vertex_count;
+    while (true) {
+        int direction = -1;
+        for (int candidate = 0; candidate < 2; ++candidate) {
+            if (!queues[candidate].empty() && queues[candidate].top().first < best_weight
+                && (direction == -1 || queues[candidate].top().first < queues[direction].top().first)) {
+                direction = candidate;
+            }
+        }
+        if (direction == -1) {
+            break;
+        }
+        const auto [weight, vertex] = queues[direction].top();
+        queues[direction].pop();
+        if (weight > weights[direction][vertex]) {
+            continue;
+        }
+        ++stats.settled_vertices;
+        if (weights[1 - direction][vertex] != INFINITE_WEIGHT
+            && weight + weights[1 - direction][vertex] < best_weight) {
+            best_weight = weight + weights[1 - direction][vertex];
+            meeting_vertex = vertex;
+        }
+        const CsrGraph<Weight>& search_graph = search_graphs_[direction];
+        for (size_t arc = search_graph.GetArcsBegin(vertex); arc < search_graph.GetArcsEnd(vertex); ++arc) {
+            const VertexId next_vertex = search_graph.GetTarget(arc);
+            const Weight candidate_weight = weight + search_graph.GetWeight(arc);
+            if (candidate_weight < weights[direction][next_vertex]) {
+                weights[direction][next_vertex] = candidate_weight;
+                prev_arcs[direction][next_vertex] = search_graph.GetEdgeId(arc);
+                queues[direction].push({candidate_weight, next_vertex});
+            }
+        }
+    }
+
+    if (meeting_vertex == vertex_count) {
+        return std::nullopt;
+    }
+    return RouteInfo{best_weight, RestoreEdges(meeting_vertex, prev_arcs[0], prev_arcs[1])};
+}
+
+template <typename Weight>
+void ContractionHierarchy<Weight>::CheckVertex(VertexId vertex) const {
+    if (vertex >= graph_.GetVertexCount()) {
+        throw std::out_of_range("Vertex id is out of range");
+    }
+}
+
+template <typename Weight>
+template <typename Settle, typename Bound>
+void ContractionHierarchy<Weight>::SearchUpward(int direction, VertexId start, SearchSpace& space,
+                                                Settle settle, Bound bound) const {
+    MinQueue queue;
+    space.weights[start] = ZERO_WEIGHT;
+    space.reached.push_back(start);
+    queue.push({ZERO_WEIGHT, start});
+    const CsrGraph<Weight>& search_graph = search_graphs_[direction];
+    while (!queue.empty() && queue.top().first < bound()) {
+        const auto [weight, vertex] = queue.top();
+        queue.pop();
+        if (weight > space.weights[vertex]) {
+            continue;
+        }
+        settle(vertex, weight);
+        for (size_t arc = search_graph.GetArcsBegin(vertex); arc < search_graph.GetArcsEnd(vertex); ++arc) {
+            const VertexId next_vertex = search_graph.GetTarget(arc);
+            const Weight candidate_weight = weight + search_graph.GetWeight(arc);
+            if (candidate_weight < space.weights[next_vertex]) {
+                if (space.weights[next_vertex] == INFINITE_WEIGHT) {
+                    space.reached.push_back(next_vertex);
+                }
+                space.weights[next_vertex] = candidate_weight;
+                space.prev_arcs[next_vertex] = search_graph.GetEdgeId(arc);
+                queue.push({candidate_weight, next_vertex});
+            }
+        }
+    }
+}
+
+template <typename Weight>
+std::vector<EdgeId> ContractionHierarchy<Weight>::RestoreEdges(VertexId meeting_vertex,
+                                                               const std::vector<EdgeId>& forward_prev_arcs,
+                                                               const std::vector<EdgeId>& backward_prev_arcs) const {
+    std::vector<EdgeId> forward_arcs;
+    for (VertexId vertex = meeting_vertex; forward_prev_arcs[vertex] != NO_ARC; vertex = GetArc(forward_prev_arcs[vertex]).from) {
+        forward_arcs.push_back(forward_prev_arcs[vertex]);
+    }
+    std::reverse(forward_arcs.begin(), forward_arcs.end());
+    for (VertexId vertex = meeting_vertex; backward_prev_arcs[vertex] != NO_ARC; vertex = GetArc(backward_prev_arcs[vertex]).to) {
+        forward_arcs.push_back(backward_prev_arcs[vertex]);
+    }
+
+    std::vector<EdgeId> edges;
+    for (const EdgeId arc_id : forward_arcs) {
+        UnpackArc(arc_id, edges);
+    }
+    return edges;
+}
+
+template <typename Weight>
+std::vector<std::optional<typename ContractionHierarchy<Weight>::RouteInfo>>
+ContractionHierarchy<Weight>::BuildRoutesFrom(VertexId from, const std::vector<VertexId>& targets, bool with_edges) const {
+    CheckVertex(from);
+    for (const VertexId to : targets) {
+        CheckVertex(to);
+    }
+    const size_t vertex_count = graph_.GetVertexCount();
+    const auto unbounded = [] { return INFINITE_WEIGHT; };
+    SearchSpace forward(vertex_count);
+    SearchUpward(0, from, forward, [](VertexId, Weight) {}, unbounded);
+
+    std::vector<std::optional<RouteInfo>> routes;
+    routes.reserve(targets.size());
+    SearchSpace backward(vertex_count);
+    for (const VertexId to : targets) {
+        Weight best_weight = INFINITE_WEIGHT;
+        VertexId meeting_vertex = vertex_count;
+        // Прямой поиск завершён, поэтому обратный можно остановить, как только он не улучшит найденный вес
+        SearchUpward(1, to, backward, [&forward, &best_weight, &meeting_vertex](VertexId vertex, Weight weight) {
+            if (forward.weights[vertex] != INFINITE_WEIGHT && forward.weights[vertex] + weight < best_weight) {
+                best_weight = forward.weights[vertex] + weight;
+                meeting_vertex = vertex;
+            }
+        }, [&best_weight] { return best_weight; });
+        if (meeting_vertex == vertex_count) {
+            routes.push_back(std::nullopt);
+        } else {
+            routes.push_back(RouteInfo{best_weight, with_edges ? RestoreEdges(meeting_vertex, forward.prev_arcs,
+                                                                              backward.prev_arcs)
+                                                               : std::vector<EdgeId>{}});
+        }
+        backward.Reset();
+    }
+    return routes;
+}
+
+template <typename Weight>
+std::vector<std::vector<std::optional<Weight>>>
+ContractionHierarchy<Weight>::BuildWeightMatrix(const std::vector<VertexId>& sources,
+                                                const std::vector<VertexId>& targets) const {
+    for (const VertexId vertex : sources) {
+        CheckVertex(vertex);
+    }
+    for (const VertexId vertex : targets) {
+        CheckVertex(vertex);
+    }
+    const size_t vertex_count = graph_.GetVertexCount();
+    const auto unbounded = [] { return INFINITE_WEIGHT; };
+    SearchSpace space(vertex_count);
+    // Корзина вершины — пары (номер цели, вес пути из вершины в цель вниз по иерархии)
+    std::vector<std::vector<std::pair<size_t, Weight>>> buckets(vertex_count);
+    for (size_t target = 0; target < targets.size(); ++target) {
+        SearchUpward(1, targets[target], space, [&buckets, target](VertexId vertex, Weight weight) {
+            buckets[vertex].push_back({target, weight});
+        }, unbounded);
+        space.Reset();
+    }
+
+    std::vector<std::vector<std::optional<Weight>>> matrix(sources.size(),
+                                                           std::vector<std::optional<Weight>>(targets.size()));
+    for (size_t source = 0; source < sources.size(); ++source) {
+        std::vector<std::optional<Weight>>& row = matrix[source];
+        SearchUpward(0, sources[source], space, [&buckets, &row](VertexId vertex, Weight weight) {
+            for (const auto& [target, target_weight] : buckets[vertex]) {
+                if (!row[target] || weight + target_weight < *row[target]) {
+                    row[target] = weight + target_weight;
+                }
+            }
+        }, unbounded);
+        space.Reset();
+    }
+    return matrix;
+}
+
+}  // namespace graph
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "graph.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+namespace graph {
+
+// Неизменяемый граф в формате CSR: исходящие дуги каждой вершины лежат подряд,
+// а их концы, веса и номера рёбер хранятся в параллельных массивах.
+// Обход соседей — последовательное чтение памяти без перехода по указателям
+template <typename Weight>
+class CsrGraph {
+public:
+    struct Arc {
+        VertexId from;
+        VertexId to;
+        Weight weight;
+        // Номер ребра, которое представляет дуга, в исходной нумерации
+        EdgeId edge_id;
+    };
+
+    CsrGraph() = default;
+
+    explicit CsrGraph(const DirectedWeightedGraph<Weight>& graph);
+
+    // Порядок дуг одной вершины совпадает с их порядком в arcs
+    CsrGraph(size_t vertex_count, const std::vector<Arc>& arcs);
+
+    size_t GetVertexCount() const {
+        return offsets_.empty() ? 0 : offsets_.size() - 1;
+    }
+
+    size_t GetArcCount() const {
+        return targets_.size();
+    }
+
+    // Дуги вершины занимают позиции [GetArcsBegin(vertex), GetArcsEnd(vertex)).
+    // Номер вершины не проверяется
+    size_t GetArcsBegin(VertexId vertex) const {
+        return offsets_[vertex];
+    }
+
+    size_t GetArcsEnd(VertexId vertex) const {
+        return offsets_[vertex + 1];
+    }
+
+    VertexId GetTarget(size_t arc) const {
+        return targets_[arc];
+    }
+
+    Weight GetWeight(size_t arc) const {
+        return weights_[arc];
+    }
+
+    EdgeId GetEdgeId(size_t arc) const {
+        return edge_ids_[arc];
+    }
+
+private:
+    std::vector<size_t> offsets_;
+    std::vector<VertexId> targets_;
+    std::vector<Weight> weights_;
+    std::vector<EdgeId> edge_ids_;
+};
+
+template <typename Weight>
+CsrGraph<Weight>::CsrGraph(const DirectedWeightedGraph<Weight>& graph) {
+    std::vector<Arc> arcs;
+    arcs.reserve(graph.GetEdgeCount());
+    for (EdgeId edge_id = 0; edge_id < graph.GetEdgeCount(); ++edge_id) {
+        const auto& edge = graph.GetEdge(edge_id);
+        arcs.push_back({edge.from, edge.to, edge.weight, edge_id});
+    }
+    *this = CsrGraph(graph.GetVertexCount(), arcs);
+}
+
+template <typename Weight>
+CsrGraph<Weight>::CsrGraph(size_t vertex_count, const std::vector<Arc>& arcs)
+    : offsets_(vertex_count + 1, 0)
+    , targets_(arcs.size())
+    , weights_(arcs.size())
+    , edge_ids_(arcs.size())
+{
+    for (const Arc& arc : arcs) {
+        if (arc.from >= vertex_count || arc.to >= vertex_count) {
+            throw std::out_of_range("Arc vertex is out of range");
+        }
+        ++offsets_[arc.from + 1];
+    }
+    for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
+        offsets_[vertex + 1] += offsets_[vertex];
+    }
+    std::vector<size_t> positions(offsets_.begin(), offsets_.end() - 1);
+    for (const Arc& arc : arcs) {
+        const size_t position = positions[arc.from]++;
+        targets_[position] = arc.to;
+        weights_[position] = arc.weight;
+        edge_ids_[position] = arc.edge_id;
+    }
+}
+
+}  // namespace graph
@@ -0,0 +1,259 @@
+#pragma once
+
+#include "csr_graph.h"
+#include "router.h"
+
+#include <functional>
+#include <limits>
+#include <queue>
+
+namespace graph {
+
+// Ищет кратчайший путь по запросу алгоритмом Дейкстры с бинарной кучей,
+// не храня таблицу маршрутов между всеми парами вершин
+template <typename Weight>
+class DijkstraRouter : public RoutingEngine<Weight> {
+private:
+    using Graph = DirectedWeightedGraph<Weight>;
+
+public:
+    using RouteInfo = typename RoutingEngine<Weight>::RouteInfo;
+
+    // csr_graph — тот же граф в формате CSR, по которому идёт поиск; движок хранит ссылки на оба графа
+    DijkstraRouter(const Graph& graph, const CsrGraph<Weight>& csr_graph);
+
+    std::optional<RouteInfo> BuildRoute(VertexId from, VertexId to) const override;
+
+    std::optional<RouteInfo> BuildRouteWithStats(VertexId from, VertexId to, SearchStats& stats) const override;
+
+    // Один поиск из from, который останавливается, когда найдены веса всех targets
+    std::vector<std::optional<RouteInfo>> BuildRoutesFrom(VertexId from, const std::vector<VertexId>& targets,
+                                                          bool with_edges) const override;
+
+private:
+    using QueueItem = std::pair<Weight, VertexId>;
+
+    struct SearchResult {
+        std::vector<std::optional<Weight>> weights;
+        std::vector<EdgeId> prev_edges;
+        size_t settled_vertices = 0;
+    };
+
+    // Дейкстра из from до извлечения из очереди всех вершин с is_target, всего их target_count
+    SearchResult Search(VertexId from, const std::vector<bool>& is_target, size_t target_count) const;
+
+    std::vector<EdgeId> RestoreEdges(const SearchResult& result, VertexId to) const;
+
+    static constexpr Weight ZERO_WEIGHT{};
+    static constexpr EdgeId NO_EDGE = std::numeric_limits<EdgeId>::max();
+    const Graph& graph_;
+    const CsrGraph<Weight>& csr_graph_;
+};
+
+template <typename Weight>
+DijkstraRouter<Weight>::DijkstraRouter(const Graph& graph, const CsrGraph<Weight>& csr_graph)
+    : graph_(graph)
+    , csr_graph_(csr_graph)
+{
+    for (EdgeId edge_id = 0; edge_id < graph.GetEdgeCount(); ++edge_id) {
+        if (graph.GetEdge(edge_id).weight < ZERO_WEIGHT) {
+            throw std::domain_error("Edges' weights should be non-negative");
+        }
+    }
+}
+
+template <typename Weight>
+std::optional<typename DijkstraRouter<Weight>::RouteInfo> DijkstraRouter<Weight>::BuildRoute(VertexId from,
+                                                                                             VertexId to) const {
+    SearchStats stats;
+    return BuildRouteWithStats(from, to, stats);
+}
+
+template <typename Weight>
+std::optional<typename DijkstraRouter<Weight>::RouteInfo>
+DijkstraRouter<Weight>::BuildRouteWithStats(VertexId from, VertexId to, SearchStats& stats) const {
+    const size_t vertex_count = graph_.GetVertexCount();
+    if (from >= vertex_count || to >= vertex_count) {
+        throw std::out_of_range("Vertex id is out of range");
+    }
+
+    std::vector<bool> is_target(vertex_count, false);
+    is_target[to] = true;
+    const SearchResult result = Search(from, is_target, 1);
+    stats.settled_vertices = result.settled_vertices;
+    if (!result.weights[to]) {
+        return std::nullopt;
+    }
+    return RouteInfo{*result.weights[to], RestoreEdges(result, to)};
+}
+
+template <typename Weight>
+std::vector<std::optional<typename DijkstraRouter<Weight>::RouteInfo>>
+DijkstraRouter<Weight>::BuildRoutesFrom(VertexId from, const std::vector<VertexId>& targets, bool with_edges) const {
+    const size_t vertex_count = graph_.GetVertexCount();
+    if (from >= vertex_count) {
+        throw std::out_of_range("Vertex id is out of range");
+    }
+    if (targets.empty()) {
+        return {};
+    }
+    std::vector<bool> is_target(vertex_count, false);
+    size_t target_count = 0;
+    for (const VertexId to : targets) {
+        if (to >= vertex_count) {
+            throw std::out_of_range("Vertex id is out of range");
+        }
+        if (!is_target[to]) {
+            is_target[to] = true;
+            ++target_count;
+        }
+    }
+
+    const SearchResult result = Search(from, is_target, target_count);
+    std::vector<std::optional<RouteInfo>> routes;
+    routes.reserve(targets.size());
+    for (const VertexId to : targets) {
+        if (!result.weights[to]) {
+            routes.push_back(std::nullopt);
+        } else {
+            routes.push_back(RouteInfo{*result.weights[to], with_edges ? RestoreEdges(result, to) : std::vector<EdgeId>{}});
+        }
+    }
+    return routes;
+}
+
+template <typename Weight>
+typename DijkstraRouter<Weight>::SearchResult
+DijkstraRouter<Weight>::Search(VertexId from, const std::vector<bool>& is_target, size_t target_count) const {
+    SearchResult result;
+    result.weights.resize(graph_.GetVertexCount());
+    result.prev_edges.assign(graph_.GetVertexCount(), NO_EDGE);
+    auto& weights = result.weights;
+    std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>> queue;
+
+    weights[from] = ZERO_WEIGHT;
+    queue.push({ZERO_WEIGHT, from});
+    while (!queue.empty()) {
+        const auto [weight, vertex] = queue.top();
+        queue.pop();
+        if (weight > *weights[vertex]) {
+            continue;
+        }
+        ++result.settled_vertices;
+        if (is_target[vertex] && --target_count == 0) {
+            break;
+        }
+        for (size_t arc = csr_graph_.GetArcsBegin(vertex); arc < csr_graph_.GetArcsEnd(vertex); ++arc) {
+            const VertexId next_vertex = csr_graph_.GetTarget(arc);
+            const Weight candidate_weight = weight + csr_graph_.GetWeight(arc);
+            if (!weights[next_vertex] || candidate_weight < *weights[next_vertex]) {
+                weights[next_vertex] = candidate_weight;
+                result.prev_edges[next_vertex] = csr_graph_.GetEdgeId(arc);
+                queue.push({candidate_weight, next_vertex});
+            }
+        }
+    }
+    return result;
+}
+
+template <typename Weight>
+std::vector<EdgeId> DijkstraRouter<Weight>::RestoreEdges(const SearchResult& result, VertexId to) const {
+    std::vector<EdgeId> edges;
+    for (EdgeId edge_id = result.prev_edges[to]; edge_id != NO_EDGE;
+         edge_id = result.prev_edges[graph_.GetEdge(edge_id).from]) {
+        edges.push_back(edge_id);
+    }
+    std::reverse(edges.begin(), edges.end());
+    return edges;
+}
+
+// Кратчайший путь из from в to по дугам graph, веса которых вычисляет arc_weight(vertex, arc) во время
+// обхода, — например, по другому профилю скорости; веса, сохранённые в graph, не используются.
+// Веса, которые возвращает arc_weight, должны быть неотрицательными
+template <typename Weight, typename ArcWeight>
+std::optional<typename RoutingEngine<Weight>::RouteInfo> FindShortestPath(const CsrGraph<Weight>& graph,
+                                                                          VertexId from, VertexId to,
+                                                                          ArcWeight arc_weight, SearchStats& stats) {
+    using QueueItem = std::pair<Weight, VertexId>;
+    constexpr size_t NO_ARC = std::numeric_limits<size_t>::max();
+    if (from >= graph.GetVertexCount() || to >= graph.GetVertexCount()) {
+        throw std::out_of_range("Vertex id is out of range");
+    }
+    std::vector<std::optional<Weight>> weights(graph.GetVertexCount());
+    std::vector<size_t> prev_arcs(graph.GetVertexCount(), NO_ARC);
+    std::vector<VertexId> prev_vertexes(graph.GetVertexCount());
+    std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>> queue;
+    stats = {};
+
+    weights[from] = Weight{};
+    queue.push({Weight{}, from});
+    while (!queue.empty()) {
+        const auto [weight, vertex] = queue.top();
+        queue.pop();
+        if (weight > *weights[vertex]) {
+            continue;
+        }
+        ++stats.settled_vertices;
+        if (vertex == to) {
+            break;
+        }
+        for (size_t arc = graph.GetArcsBegin(vertex); arc < graph.GetArcsEnd(vertex); ++arc) {
+            const VertexId next_vertex = graph.GetTarget(arc);
+            const Weight candidate_weight = weight + arc_weight(vertex, arc);
+            if (!weights[next_vertex] || candidate_weight < *weights[next_vertex]) {
+                weights[next_vertex] = candidate_weight;
+                prev_arcs[next_vertex] = arc;
+                prev_vertexes[next_vertex] = vertex;
+                queue.push({candidate_weight, next_vertex});
+            }
+        }
+    }
+    if (!weights[to]) {
+        return std::nullopt;
+    }
+    std::vector<EdgeId> edges;
+    for (VertexId vertex = to; prev_arcs[vertex] != NO_ARC; vertex = prev_vertexes[vertex]) {
+        edges.push_back(graph.GetEdgeId(prev_arcs[vertex]));
+    }
+    std::reverse(edges.begin(), edges.end());
+    return typename RoutingEngine<Weight>::RouteInfo{*weights[to], std::move(edges)};
+}
+
+// Вершины, достижимые из from по путям веса не больше max_weight, с весами кратчайших путей
+// в порядке их извлечения из очереди. Вершины тяжелее max_weight не раскрываются
+template <typename Weight>
+std::vector<std::pair<VertexId, Weight>> FindReachableVertices(const CsrGraph<Weight>& graph, VertexId from,
+                                                               Weight max_weight) {
+    using QueueItem = std::pair<Weight, VertexId>;
+    if (from >= graph.GetVertexCount()) {
+        throw std::out_of_range("Vertex id is out of range");
+    }
+    std::vector<std::optional<Weight>> weights(graph.GetVertexCount());
+    std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>> queue;
+    std::vector<std::pair<VertexId, Weight>> reachable;
+    if (max_weight < Weight{}) {
+        return reachable;
+    }
+
+    weights[from] = Weight{};
+    queue.push({Weight{}, from});
+    while (!queue.empty()) {
+        const auto [weight, vertex] = queue.top();
+        queue.pop();
+        if (weight > *weights[vertex]) {
+            continue;
+        }
+        reachable.push_back({vertex, weight});
+        for (size_t arc = graph.GetArcsBegin(vertex); arc < graph.GetArcsEnd(vertex); ++arc) {
+            const VertexId next_vertex = graph.GetTarget(arc);
+            const Weight candidate_weight = weight + graph.GetWeight(arc);
+            if (candidate_weight <= max_weight && (!weights[next_vertex] || candidate_weight < *weights[next_vertex])) {
+                weights[next_vertex] = candidate_weight;
+                queue.push({candidate_weight, next_vertex});
+            }
+        }
+    }
+    return reachable;
+}
+
+}  // namespace graph
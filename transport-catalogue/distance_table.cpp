@@ -0,0 +1,70 @@
+#include "distance_table.h"
+
+#include <algorithm>
+
+namespace catalogue {
+
+uint64_t DistanceTable::MakeKey(StopId src, StopId dst) {
+    return (static_cast<uint64_t>(src) << 32) | dst;
+}
+
+size_t DistanceTable::GetFirstSlot(StopId src, StopId dst) const {
+    // Фибоначчиево хеширование ключа из упорядоченной пары; размер таблицы — степень двойки
+    const uint64_t hash = MakeKey(std::min(src, dst), std::max(src, dst)) * 0x9E3779B97F4A7C15ull;
+    return static_cast<size_t>(hash >> 32) & (slots_.size() - 1);
+}
+
+void DistanceTable::Set(StopId src, StopId dst, int64_t distance) {
+    if (2 * (size_ + 1) > slots_.size()) {
+        Grow();
+    }
+    const uint64_t key = MakeKey(src, dst);
+    const size_t mask = slots_.size() - 1;
+    for (size_t slot = GetFirstSlot(src, dst);; slot = (slot + 1) & mask) {
+        if (slots_[slot].key == key) {
+            slots_[slot].distance = distance;
+            return;
+        }
+        if (slots_[slot].key == EMPTY_KEY) {
+            slots_[slot] = {key, distance};
+            ++size_;
+            return;
+        }
+    }
+}
+
+std::optional<int64_t> DistanceTable::Get(StopId src, StopId dst) const {
+    if (slots_.empty()) {
+        return std::nullopt;
+    }
+    const uint64_t forward_key = MakeKey(src, dst);
+    const uint64_t backward_key = MakeKey(dst, src);
+    const size_t mask = slots_.size() - 1;
+    std::optional<int64_t> backward_distance;
+    for (size_t slot = GetFirstSlot(src, dst); slots_[slot].key != EMPTY_KEY; slot = (slot + 1) & mask) {
+        if (slots_[slot].key == forward_key) {
+            return slots_[slot].distance;
+        }
+        if (slots_[slot].key == backward_key) {
+            backward_distance = slots_[slot].distance;
+        }
+    }
+    return backward_distance;
+}
+
+size_t DistanceTable::GetSize() const {
+    return size_;
+}
+
+void DistanceTable::Grow() {
+    std::vector<Slot> old_slots(std::max<size_t>(16, 2 * slots_.size()));
+    old_slots.swap(slots_);
+    size_ = 0;
+    for (const Slot& slot : old_slots) {
+        if (slot.key != EMPTY_KEY) {
+            Set(static_cast<StopId>(slot.key >> 32), static_cast<StopId>(slot.key), slot.distance);
+        }
+    }
+}
+
+} // namespace catalogue
@@ -0,0 +1,55 @@
+#pragma once
+#include "domain.h"
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace catalogue {
+
+// Расстояния между парами остановок в плоской таблице с открытой адресацией и линейным пробированием.
+// Хеш не зависит от порядка остановок в паре, поэтому расстояния в обе стороны лежат в одной
+// последовательности проб: прямое находится или подменяет обратное за один проход
+class DistanceTable {
+public:
+    void Set(StopId src, StopId dst, int64_t distance);
+
+    // Расстояние от src до dst, при его отсутствии — от dst до src; std::nullopt — расстояние неизвестно
+    std::optional<int64_t> Get(StopId src, StopId dst) const;
+
+    size_t GetSize() const;
+
+    // Вызывает callback(src, dst, distance) для каждого заданного расстояния
+    template <typename Callback>
+    void ForEach(Callback callback) const;
+
+private:
+    struct Slot {
+        uint64_t key = EMPTY_KEY;
+        int64_t distance = 0;
+    };
+
+    // Номер остановки меньше 2^32 - 1, так что пара из двух наибольших номеров ключом быть не может
+    static constexpr uint64_t EMPTY_KEY = UINT64_MAX;
+
+    static uint64_t MakeKey(StopId src, StopId dst);
+
+    size_t GetFirstSlot(StopId src, StopId dst) const;
+
+    // Удваивает таблицу, когда она заполнена больше чем наполовину
+    void Grow();
+
+    std::vector<Slot> slots_;
+    size_t size_ = 0;
+};
+
+template <typename Callback>
+void DistanceTable::ForEach(Callback callback) const {
+    for (const Slot& slot : slots_) {
+        if (slot.key != EMPTY_KEY) {
+            callback(static_cast<StopId>(slot.key >> 32), static_cast<StopId>(slot.key), slot.distance);
+        }
+    }
+}
+
+} // namespace catalogue
@@ -3,14 +3,12 @@
 namespace catalogue {
     
     Stop::Stop() = default;
-    Stop::Stop(std::string stop_name, geo::Coordinates geo_data)
-        : name(std::move(stop_name))
+    Stop::Stop(std::string_view stop_name, geo::Coordinates geo_data)
+        : name(stop_name)
         , coordinates(geo_data) {}
     
-    Bus::Bus() = default;
-    Bus::Bus(std::string bus, std::vector<const Stop*> route, bool roundtrip)
-        : name(std::move(bus))
-        , stops(std::move(route))
-        , is_roundtrip(roundtrip) {}
+    BusStops::BusStops(const StopId* begin, const StopId* end)
+        : begin_(begin)
+        , end_(end) {}
 
 } // namespace catalogue
\ No newline at end of file
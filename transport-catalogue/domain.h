@@ -1,29 +1,59 @@
 #pragma once
 #include "geo.h"
 
+#include <cstdint>
+#include <iterator>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace catalogue {
-using Buses = std::optional<std::vector<std::string_view>>;
+// Плотные номера остановок и автобусов: порядковый номер добавления в каталог
+using StopId = uint32_t;
+using BusId = uint32_t;
+
+// Названия автобусов остановки по возрастанию, принадлежат каталогу; nullptr — остановки нет
+using Buses = const std::vector<std::string_view>*;
 using Stops = std::vector<std::string_view>;
     
 struct Stop {
     Stop();
-    Stop(std::string stop_name, geo::Coordinates geo_data);
+    Stop(std::string_view stop_name, geo::Coordinates geo_data);
     
-    std::string name;
+    // При добавлении в каталог указывает на копию названия в его хранилище строк
+    std::string_view name;
     geo::Coordinates coordinates;
+    StopId id = 0; // назначается каталогом
 };
     
-struct Bus {
-    Bus();
-    Bus(std::string bus, std::vector<const Stop*> route, bool roundtrip);
+// Остановки автобуса — участок общего массива остановок всех автобусов каталога
+class BusStops {
+public:
+    using const_reverse_iterator = std::reverse_iterator<const StopId*>;
+    
+    BusStops() = default;
+    BusStops(const StopId* begin, const StopId* end);
+    
+    const StopId* begin() const { return begin_; }
+    const StopId* end() const { return end_; }
+    const_reverse_iterator rbegin() const { return const_reverse_iterator(end_); }
+    const_reverse_iterator rend() const { return const_reverse_iterator(begin_); }
+    size_t size() const { return static_cast<size_t>(end_ - begin_); }
+    bool empty() const { return begin_ == end_; }
+    StopId operator[](size_t index) const { return begin_[index]; }
     
-    std::string name;
-    std::vector<const Stop*> stops;
-    bool is_roundtrip;
+private:
+    const StopId* begin_ = nullptr;
+    const StopId* end_ = nullptr;
+};
+    
+struct Bus {
+    // Название и остановки задаются каталогом при добавлении автобуса
+    std::string_view name;
+    BusStops stops;
+    bool is_roundtrip = false;
+    BusId id = 0; // назначается каталогом
 };
     
 struct BusStat {
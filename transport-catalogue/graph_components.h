@@ -0,0 +1,126 @@
+#pragma once
+
+#include "csr_graph.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+namespace graph {
+
+// Компоненты связности ориентированного графа для проверки недостижимости за O(1).
+// Разные компоненты сильной связности сами по себе не означают недостижимость: между ними
+// могут быть пути в одну сторону. Поэтому используются только два достаточных признака —
+// разные компоненты слабой связности и обратный топологический порядок компонент сильной связности
+struct GraphComponents {
+    // Компоненты сильной связности в обратном топологическом порядке:
+    // если есть путь из u в v, то strong[u] >= strong[v]
+    std::vector<uint32_t> strong;
+    // Компоненты слабой связности
+    std::vector<uint32_t> weak;
+
+    // true — пути из from в to точно нет; false — путь может быть
+    bool IsUnreachable(VertexId from, VertexId to) const {
+        return weak[from] != weak[to] || strong[from] < strong[to];
+    }
+};
+
+namespace detail {
+
+// Итеративный алгоритм Тарьяна: компоненты получают номера в порядке завершения,
+// то есть в обратном топологическом порядке
+template <typename Weight>
+std::vector<uint32_t> ComputeStrongComponents(const CsrGraph<Weight>& graph) {
+    constexpr uint32_t NO_INDEX = std::numeric_limits<uint32_t>::max();
+    const size_t vertex_count = graph.GetVertexCount();
+    std::vector<uint32_t> components(vertex_count, NO_INDEX);
+    std::vector<uint32_t> indexes(vertex_count, NO_INDEX);
+    std::vector<uint32_t> low_links(vertex_count);
+    std::vector<VertexId> stack;
+    // Вершина и следующая непросмотренная дуга
+    std::vector<std::pair<VertexId, size_t>> call_stack;
+    uint32_t next_index = 0;
+    uint32_t component_count = 0;
+
+    for (VertexId root = 0; root < vertex_count; ++root) {
+        if (indexes[root] != NO_INDEX) {
+            continue;
+        }
+        call_stack.push_back({root, graph.GetArcsBegin(root)});
+        indexes[root] = low_links[root] = next_index++;
+        stack.push_back(root);
+        while (!call_stack.empty()) {
+            auto& [vertex, arc] = call_stack.back();
+            if (arc < graph.GetArcsEnd(vertex)) {
+                const VertexId next_vertex = graph.GetTarget(arc++);
+                if (indexes[next_vertex] == NO_INDEX) {
+                    indexes[next_vertex] = low_links[next_vertex] = next_index++;
+                    stack.push_back(next_vertex);
+                    call_stack.push_back({next_vertex, graph.GetArcsBegin(next_vertex)});
+                } else if (components[next_vertex] == NO_INDEX) {
+                    low_links[vertex] = std::min(low_links[vertex], indexes[next_vertex]);
+                }
+                continue;
+            }
+            const VertexId finished = vertex;
+            call_stack.pop_back();
+            if (!call_stack.empty()) {
+                const VertexId parent = call_stack.back().first;
+                low_links[parent] = std::min(low_links[parent], low_links[finished]);
+            }
+            if (low_links[finished] == indexes[finished]) {
+                VertexId member;
+                do {
+                    member = stack.back();
+                    stack.pop_back();
+                    components[member] = component_count;
+                } while (member != finished);
+                ++component_count;
+            }
+        }
+    }
+    return components;
+}
+
+template <typename Weight>
+std::vector<uint32_t> ComputeWeakComponents(const CsrGraph<Weight>& graph) {
+    const size_t vertex_count = graph.GetVertexCount();
+    std::vector<VertexId> parents(vertex_count);
+    std::iota(parents.begin(), parents.end(), VertexId{0});
+    const auto find_root = [&parents](VertexId vertex) {
+        while (parents[vertex] != vertex) {
+            parents[vertex] = parents[parents[vertex]];
+            vertex = parents[vertex];
+        }
+        return vertex;
+    };
+    for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
+        for (size_t arc = graph.GetArcsBegin(vertex); arc < graph.GetArcsEnd(vertex); ++arc) {
+            const VertexId lhs = find_root(vertex);
+            const VertexId rhs = find_root(graph.GetTarget(arc));
+            if (lhs != rhs) {
+                parents[std::max(lhs, rhs)] = std::min(lhs, rhs);
+            }
+        }
+    }
+    // Корень — наименьшая вершина компоненты, поэтому он встречается раньше остальных её вершин
+    std::vector<uint32_t> components(vertex_count);
+    uint32_t component_count = 0;
+    for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
+        const VertexId root = find_root(vertex);
+        components[vertex] = root == vertex ? component_count++ : components[root];
+    }
+    return components;
+}
+
+}  // namespace detail
+
+template <typename Weight>
+GraphComponents ComputeGraphComponents(const CsrGraph<Weight>& graph) {
+    return {detail::ComputeStrongComponents(graph), detail::ComputeWeakComponents(graph)};
+}
+
+}  // namespace graph
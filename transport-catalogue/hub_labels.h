@@ -0,0 +1,262 @@
+#pragma once
+
+#include "contraction_hierarchy.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace graph {
+
+// Индекс меток-хабов (Hub Labeling): у каждой вершины есть прямая метка — хабы, достижимые из неё,
+// и обратная — хабы, из которых достижима она, с расстояниями. Для любой пары вершин среди общих
+// хабов прямой метки from и обратной метки to есть вершина кратчайшего пути, поэтому вес
+// кратчайшего пути находится слиянием двух отсортированных списков без поиска по графу.
+// Метки строятся по порядку иерархии сжатия: метка вершины — её поиск вверх по иерархии,
+// из которого удалены хабы, до которых через более высокие хабы не дальше.
+// Маршрут не восстанавливается, только его вес
+template <typename Weight>
+class HubLabels {
+private:
+    using Graph = DirectedWeightedGraph<Weight>;
+
+public:
+    // Метки всех вершин подряд: метка вершины v занимает позиции [offsets[v], offsets[v + 1])
+    // в hubs и weights, хабы в ней упорядочены по возрастанию
+    struct Labels {
+        std::vector<uint64_t> offsets;
+        std::vector<VertexId> hubs;
+        std::vector<Weight> weights;
+    };
+
+    struct LabelsData {
+        Labels forward;
+        Labels backward;
+    };
+
+    HubLabels(const Graph& graph, const typename ContractionHierarchy<Weight>::HierarchyData& hierarchy_data);
+
+    // Восстанавливает индекс, ранее построенный для графа с vertex_count вершинами
+    HubLabels(size_t vertex_count, LabelsData labels_data);
+
+    // std::nullopt — пути нет
+    std::optional<Weight> GetWeight(VertexId from, VertexId to) const;
+
+    const LabelsData& GetLabelsData() const;
+
+private:
+    using Label = std::vector<std::pair<VertexId, Weight>>;
+
+    struct Arc {
+        VertexId from;
+        VertexId to;
+        Weight weight;
+    };
+
+    // Метки в порядке убывания ранга: метка вершины — её метка по дугам вверх, объединённая
+    // с метками концов этих дуг, которые к этому моменту уже построены
+    static std::vector<Label> BuildLabels(size_t vertex_count, const std::vector<uint32_t>& ranks,
+                                          const std::vector<Arc>& up_arcs);
+
+    // Удаляет из меток хабы, расстояние до которых достигается через другие хабы
+    static void PruneLabels(std::vector<Label>& labels, const std::vector<Label>& opposite_labels);
+
+    static std::optional<Weight> MergeLabels(const VertexId* lhs_hubs, const Weight* lhs_weights, size_t lhs_size,
+                                             const VertexId* rhs_hubs, const Weight* rhs_weights, size_t rhs_size);
+
+    static Labels FlattenLabels(const std::vector<Label>& labels);
+
+    size_t vertex_count_;
+    LabelsData labels_data_;
+};
+
+template <typename Weight>
+HubLabels<Weight>::HubLabels(const Graph& graph,
+                             const typename ContractionHierarchy<Weight>::HierarchyData& hierarchy_data)
+    : vertex_count_(graph.GetVertexCount())
+{
+    const std::vector<uint32_t>& ranks = hierarchy_data.ranks;
+    if (ranks.size() != vertex_count_) {
+        throw std::invalid_argument("Hierarchy doesn't match the graph");
+    }
+    // Дуги иерархии вверх: для прямых меток — по направлению дуги, для обратных — против него
+    std::vector<Arc> forward_arcs;
+    std::vector<Arc> backward_arcs;
+    const auto add_arc = [&ranks, &forward_arcs, &backward_arcs](VertexId from, VertexId to, Weight weight) {
+        if (ranks[from] < ranks[to]) {
+            forward_arcs.push_back({from, to, weight});
+        } else if (ranks[from] > ranks[to]) {
+            backward_arcs.push_back({to, from, weight});
+        }
+    };
+    for (EdgeId edge_id = 0; edge_id < graph.GetEdgeCount(); ++edge_id) {
+        const auto& edge = graph.GetEdge(edge_id);
+        add_arc(edge.from, edge.to, edge.weight);
+    }
+    for (const auto& shortcut : hierarchy_data.shortcuts) {
+        add_arc(shortcut.from, shortcut.to, shortcut.weight);
+    }
+
+    std::vector<Label> forward_labels = BuildLabels(vertex_count_, ranks, forward_arcs);
+    std::vector<Label> backward_labels = BuildLabels(vertex_count_, ranks, backward_arcs);
+    PruneLabels(forward_labels, backward_labels);
+    PruneLabels(backward_labels, forward_labels);
+    labels_data_.forward = FlattenLabels(forward_labels);
+    labels_data_.backward = FlattenLabels(backward_labels);
+}
+
+template <typename Weight>
+HubLabels<Weight>::HubLabels(size_t vertex_count, LabelsData labels_data)
+    : vertex_count_(vertex_count)
+    , labels_data_(std::move(labels_data))
+{
+    for (const Labels* labels : {&labels_data_.forward, &labels_data_.backward}) {
+        if (labels->offsets.size() != vertex_count_ + 1 || labels->hubs.size() != labels->weights.size()
+            || labels->offsets.back() != labels->hubs.size()) {
+            throw std::invalid_argument("Hub labels don't match the graph");
+        }
+    }
+}
+
+template <typename Weight>
+std::vector<typename HubLabels<Weight>::Label> HubLabels<Weight>::BuildLabels(size_t vertex_count,
+                                                                            const std::vector<uint32_t>& ranks,
+                                                                            const std::vector<Arc>& up_arcs) {
+    CsrGraph<Weight> up_graph(vertex_count, [&up_arcs] {
+        std::vector<typename CsrGraph<Weight>::Arc> arcs;
+        arcs.reserve(up_arcs.size());
+        for (const Arc& arc : up_arcs) {
+            arcs.push_back({arc.from, arc.to, arc.weight, 0});
+        }
+        return arcs;
+    }());
+    std::vector<VertexId> order(vertex_count);
+    for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
+        order[vertex] = vertex;
+    }
+    std::sort(order.begin(), order.end(), [&ranks](VertexId lhs, VertexId rhs) {
+        return ranks[lhs] > ranks[rhs];
+    });
+
+    std::vector<Label> labels(vertex_count);
+    std::vector<std::optional<Weight>> best_weights(vertex_count);
+    std::vector<VertexId> touched_hubs;
+    for (const VertexId vertex : order) {
+        best_weights[vertex] = Weight{};
+        touched_hubs.push_back(vertex);
+        for (size_t arc = up_graph.GetArcsBegin(vertex); arc < up_graph.GetArcsEnd(vertex); ++arc) {
+            const Weight arc_weight = up_graph.GetWeight(arc);
+            for (const auto& [hub, weight] : labels[up_graph.GetTarget(arc)]) {
+                const Weight candidate_weight = arc_weight + weight;
+                if (!best_weights[hub]) {
+                    best_weights[hub] = candidate_weight;
+                    touched_hubs.push_back(hub);
+                } else if (candidate_weight < *best_weights[hub]) {
+                    best_weights[hub] = candidate_weight;
+                }
+            }
+        }
+        std::sort(touched_hubs.begin(), touched_hubs.end());
+        Label& label = labels[vertex];
+        label.reserve(touched_hubs.size());
+        for (const VertexId hub : touched_hubs) {
+            label.push_back({hub, *best_weights[hub]});
+            best_weights[hub].reset();
+        }
+        touched_hubs.clear();
+    }
+    return labels;
+}
+
+template <typename Weight>
+void HubLabels<Weight>::PruneLabels(std::vector<Label>& labels, const std::vector<Label>& opposite_labels) {
+    // Хаб h лишний, если через какой-то общий хаб метки вершины и противоположной метки h путь короче.
+    // Все метки хранят длины реальных путей, а хаб с самым высоким рангом на кратчайшем пути
+    // всегда имеет точное расстояние и не удаляется, поэтому ответы запросов не меняются
+    std::vector<std::optional<Weight>> label_weights(labels.size());
+    for (VertexId vertex = 0; vertex < labels.size(); ++vertex) {
+        Label& label = labels[vertex];
+        for (const auto& [hub, weight] : label) {
+            label_weights[hub] = weight;
+        }
+        const auto is_dominated = [&label_weights, &opposite_labels](const std::pair<VertexId, Weight>& entry) {
+            for (const auto& [hub, weight] : opposite_labels[entry.first]) {
+                if (hub != entry.first && label_weights[hub] && *label_weights[hub] + weight < entry.second) {
+                    return true;
+                }
+            }
+            return false;
+        };
+        Label pruned_label;
+        for (const auto& entry : label) {
+            if (entry.first == vertex || !is_dominated(entry)) {
+                pruned_label.push_back(entry);
+            }
+        }
+        for (const auto& [hub, weight] : label) {
+            label_weights[hub].reset();
+        }
+        label = std::move(pruned_label);
+    }
+}
+
+template <typename Weight>
+std::optional<Weight> HubLabels<Weight>::MergeLabels(const VertexId* lhs_hubs, const Weight* lhs_weights, size_t lhs_size,
+                                                     const VertexId* rhs_hubs, const Weight* rhs_weights, size_t rhs_size) {
+    std::optional<Weight> best_weight;
+    size_t lhs = 0;
+    size_t rhs = 0;
+    while (lhs < lhs_size && rhs < rhs_size) {
+        if (lhs_hubs[lhs] < rhs_hubs[rhs]) {
+            ++lhs;
+        } else if (rhs_hubs[rhs] < lhs_hubs[lhs]) {
+            ++rhs;
+        } else {
+            const Weight weight = lhs_weights[lhs] + rhs_weights[rhs];
+            if (!best_weight || weight < *best_weight) {
+                best_weight = weight;
+            }
+            ++lhs;
+            ++rhs;
+        }
+    }
+    return best_weight;
+}
+
+template <typename Weight>
+typename HubLabels<Weight>::Labels HubLabels<Weight>::FlattenLabels(const std::vector<Label>& labels) {
+    Labels flat_labels;
+    flat_labels.offsets.reserve(labels.size() + 1);
+    flat_labels.offsets.push_back(0);
+    for (const Label& label : labels) {
+        for (const auto& [hub, weight] : label) {
+            flat_labels.hubs.push_back(hub);
+            flat_labels.weights.push_back(weight);
+        }
+        flat_labels.offsets.push_back(flat_labels.hubs.size());
+    }
+    return flat_labels;
+}
+
+template <typename Weight>
+std::optional<Weight> HubLabels<Weight>::GetWeight(VertexId from, VertexId to) const {
+    if (from >= vertex_count_ || to >= vertex_count_) {
+        throw std::out_of_range("Vertex id is out of range");
+    }
+    const Labels& forward = labels_data_.forward;
+    const Labels& backward = labels_data_.backward;
+    return MergeLabels(forward.hubs.data() + forward.offsets[from], forward.weights.data() + forward.offsets[from],
+                       forward.offsets[from + 1] - forward.offsets[from],
+                       backward.hubs.data() + backward.offsets[to], backward.weights.data() + backward.offsets[to],
+                       backward.offsets[to + 1] - backward.offsets[to]);
+}
+
+template <typename Weight>
+const typename HubLabels<Weight>::LabelsData& HubLabels<Weight>::GetLabelsData() const {
+    return labels_data_;
+}
+
+}  // namespace graph
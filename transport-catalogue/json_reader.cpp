@@ -12,29 +12,29 @@ Stop JsonReader::GetStop(const json::Dict& raw_stop) {
     return stop;
 }
 
-Stops JsonReader::GetAllStops(const json::Dict& raw_bus) {
-    Stops stops;
-    for (const auto& stop : raw_bus.at("stops").AsArray()) {
-        stops.push_back(stop.AsString());
-    }
-    return stops;
-}
-
-Bus JsonReader::GetBus(const json::Dict& raw_bus) {
-    Bus bus;
-    bus.name = raw_bus.at("name").AsString();
-    for (auto stop_name : GetAllStops(raw_bus)) {
-        bus.stops.push_back(db_.GetStop(stop_name));
+void JsonReader::AddBus(const json::Dict& raw_bus) {
+    const std::string& bus_name = raw_bus.at("name").AsString();
+    const json::Array& stop_names = raw_bus.at("stops").AsArray();
+    std::vector<StopId> stops;
+    stops.reserve(stop_names.size());
+    for (const auto& stop_name : stop_names) {
+        const Stop* stop = db_.GetStop(stop_name.AsString());
+        if (stop == nullptr) {
+            throw std::invalid_argument("Bus " + bus_name + " refers to an unknown stop: " + stop_name.AsString());
+        }
+        stops.push_back(stop->id);
     }
-    bus.is_roundtrip = raw_bus.at("is_roundtrip").AsBool();
-    return bus;
+    db_.AddBus(bus_name, stops, raw_bus.at("is_roundtrip").AsBool());
 }
     
 void JsonReader::SetRealDistance(const json::Dict& new_stops) {
-    std::string stop = new_stops.at("name").AsString();
-    const Stop* stop_src = db_.GetStop(stop);
+    const Stop* stop_src = db_.GetStop(new_stops.at("name").AsString());
     for (const auto& [destination, distance] : new_stops.at("road_distances").AsDict()) {
         const Stop* stop_dst = db_.GetStop(destination);
+        if (stop_dst == nullptr) {
+            throw std::invalid_argument("Stop " + std::string(stop_src->name) + " has a distance to an unknown stop: "
+                                        + destination);
+        }
         db_.SetDistance(stop_src, stop_dst, distance.AsInt());
     }
 }
@@ -66,8 +66,54 @@ void JsonReader::SetRenderSettings(renderer::MapRenderer& renderer, const json::
 
 void JsonReader::SetRoutingSettings(TransportRouter& router, const json::Node& settings) {
     json::Dict routing_settings = settings.AsDict();
+    RouterMode mode = RouterMode::ALL_PAIRS;
+    if (routing_settings.count("router_mode") != 0) {
+        const std::string& raw_mode = routing_settings.at("router_mode").AsString();
+        if (raw_mode == "dijkstra") {
+            mode = RouterMode::DIJKSTRA;
+        } else if (raw_mode == "stop_pairs") {
+            mode = RouterMode::STOP_PAIRS;
+        } else if (raw_mode == "contraction_hierarchies") {
+            mode = RouterMode::CONTRACTION_HIERARCHIES;
+        } else if (raw_mode == "a_star") {
+            mode = RouterMode::A_STAR;
+        } else if (raw_mode == "raptor") {
+            mode = RouterMode::RAPTOR;
+        } else if (raw_mode != "all_pairs") {
+            throw std::invalid_argument("Unknown router mode: " + raw_mode);
+        }
+    }
+    size_t thread_count = 1;
+    if (routing_settings.count("thread_count") != 0) {
+        thread_count = routing_settings.at("thread_count").AsInt();
+    }
+    bool compact_table = false;
+    if (routing_settings.count("compact_table") != 0) {
+        compact_table = routing_settings.at("compact_table").AsBool();
+    }
+    size_t route_cache_size = 0;
+    if (routing_settings.count("route_cache_size") != 0) {
+        route_cache_size = routing_settings.at("route_cache_size").AsInt();
+    }
+    bool hub_labels = false;
+    if (routing_settings.count("hub_labels") != 0) {
+        hub_labels = routing_settings.at("hub_labels").AsBool();
+    }
+    std::map<std::string, RoutingProfile, std::less<>> profiles;
+    if (routing_settings.count("profiles") != 0) {
+        for (const auto& [name, profile] : routing_settings.at("profiles").AsDict()) {
+            profiles[name] = {profile.AsDict().at("bus_wait_time").AsDouble(),
+                              profile.AsDict().at("bus_velocity").AsDouble()};
+        }
+    }
     router.SetSettings({routing_settings.at("bus_wait_time").AsInt(),
-                        routing_settings.at("bus_velocity").AsDouble()});
+                        routing_settings.at("bus_velocity").AsDouble(),
+                        mode,
+                        thread_count,
+                        compact_table,
+                        route_cache_size,
+                        std::move(profiles),
+                        hub_labels});
 }
 
 void JsonReader::SetSerializationSettings(Serializer& serializer, const json::Node& settings) {
@@ -76,21 +122,26 @@ void JsonReader::SetSerializationSettings(Serializer& serializer, const json::No
 }
     
 void JsonReader::ReadBaseRequests(const json::Node& base_requests) {
+    // Запросы не копируются: названия остановок и автобусов копирует только каталог, в своё хранилище строк
     IdentifiedRequests identified;
     for (const auto& element : base_requests.AsArray()) {
-        json::Dict request = element.AsDict();
-        if (request["type"].AsString() == "Bus") {
-            identified.new_buses.push_back(move(request));
-        } else if (request["type"].AsString() == "Stop") {
-            db_.AddStop(GetStop(request));
-            identified.new_stops.push_back(move(request));
+        const json::Dict& request = element.AsDict();
+        const std::string& type = request.at("type").AsString();
+        if (type == "Bus") {
+            identified.new_buses.push_back(&request);
+        } else if (type == "Stop") {
+            identified.new_stops.push_back(&request);
         }
     }
-    for (const auto& new_stop : identified.new_stops) {
-        SetRealDistance(new_stop.AsDict());
+    db_.ReserveStops(db_.GetStopsCount() + identified.new_stops.size());
+    for (const json::Dict* new_stop : identified.new_stops) {
+        db_.AddStop(GetStop(*new_stop));
+    }
+    for (const json::Dict* new_stop : identified.new_stops) {
+        SetRealDistance(*new_stop);
     }
-    for (const auto& new_bus : identified.new_buses) {
-        db_.AddBus(GetBus(new_bus.AsDict()));
+    for (const json::Dict* new_bus : identified.new_buses) {
+        AddBus(*new_bus);
     }
 }
 
@@ -28,15 +28,13 @@ private:
     TransportCatalogue& db_;
     
     struct IdentifiedRequests {
-        std::vector<json::Node> new_stops;
-        std::vector<json::Node> new_buses;
+        std::vector<const json::Dict*> new_stops;
+        std::vector<const json::Dict*> new_buses;
     };
     
     Stop GetStop(const json::Dict& raw_stop);
     
-    Stops GetAllStops(const json::Dict& raw_bus);
-   
-    Bus GetBus(const json::Dict& raw_bus);
+    void AddBus(const json::Dict& raw_bus);
 };
 
 } // namespace json_rd
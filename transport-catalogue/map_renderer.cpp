@@ -9,14 +9,17 @@ MapRenderer::MapRenderer() = default;
     
 bool AlmostZero(double value) { return std::abs(value) < 1e-6; }
 
-svg::Document MapRenderer::RenderMap(const std::map<std::string_view, const Bus*>& buses) const {
+svg::Document MapRenderer::RenderMap(const TransportCatalogue& db) const {
+    const std::vector<const Bus*>& buses = db.GetAllBuses();
     svg::Document svg_doc;
     auto comp = [](const Stop* lhs, const Stop* rhs) {
         return lhs->name < rhs->name;
     };
     std::set<const Stop*, decltype(comp)> stop_ptr_arr(comp);
-    for (const auto& [bus_name, bus_ptr] : buses) {
-        stop_ptr_arr.insert(bus_ptr->stops.begin(), bus_ptr->stops.end());
+    for (const Bus* bus_ptr : buses) {
+        for (const StopId stop : bus_ptr->stops) {
+            stop_ptr_arr.insert(db.GetStopById(stop));
+        }
     }
     SphereProjector projector(stop_ptr_arr.begin(),
                               stop_ptr_arr.end(),
@@ -24,23 +27,23 @@ svg::Document MapRenderer::RenderMap(const std::map<std::string_view, const Bus*
                               render_settings_.height,
                               render_settings_.padding);
     int route_count = 0;
-    for (const auto& [bus_name, bus_ptr] : buses) {
-        svg_doc.Add(RenderBusRoute(projector, bus_ptr, route_count));
+    for (const Bus* bus_ptr : buses) {
+        svg_doc.Add(RenderBusRoute(projector, db, bus_ptr, route_count));
         ++route_count;
     }
     route_count = 0;
 
-    for (const auto& [bus_name, bus_ptr] : buses) {
+    for (const Bus* bus_ptr : buses) {
         if (bus_ptr->stops.size() == 0) {
             break;
         }
-        svg_doc.Add(RenderBusNameUnderlayer(bus_ptr, projector(bus_ptr->stops[0]->coordinates)));
-        svg_doc.Add(RenderBusName(bus_ptr, projector(bus_ptr->stops[0]->coordinates), route_count));
-        if (bus_ptr->stops[0] != bus_ptr->stops[bus_ptr->stops.size() - 1]) {
-            svg_doc.Add(RenderBusNameUnderlayer(
-                bus_ptr, projector(bus_ptr->stops[bus_ptr->stops.size() - 1]->coordinates)));
-            svg_doc.Add(RenderBusName(
-                bus_ptr, projector(bus_ptr->stops[bus_ptr->stops.size() - 1]->coordinates), route_count));
+        const Stop* first_stop = db.GetStopById(bus_ptr->stops[0]);
+        const Stop* last_stop = db.GetStopById(bus_ptr->stops[bus_ptr->stops.size() - 1]);
+        svg_doc.Add(RenderBusNameUnderlayer(bus_ptr, projector(first_stop->coordinates)));
+        svg_doc.Add(RenderBusName(bus_ptr, projector(first_stop->coordinates), route_count));
+        if (first_stop != last_stop) {
+            svg_doc.Add(RenderBusNameUnderlayer(bus_ptr, projector(last_stop->coordinates)));
+            svg_doc.Add(RenderBusName(bus_ptr, projector(last_stop->coordinates), route_count));
         }
         ++route_count;
     }
@@ -57,14 +60,15 @@ svg::Document MapRenderer::RenderMap(const std::map<std::string_view, const Bus*
     return svg_doc;
 }
     
-svg::Polyline MapRenderer::RenderBusRoute(SphereProjector& proj, const Bus* bus, int color_num) const {
+svg::Polyline MapRenderer::RenderBusRoute(SphereProjector& proj, const TransportCatalogue& db, const Bus* bus,
+                                          int color_num) const {
     svg::Polyline route;
-    for (const auto& stop : bus->stops) {
-        route.AddPoint(proj(stop->coordinates));
+    for (const StopId stop : bus->stops) {
+        route.AddPoint(proj(db.GetStopCoordinates(stop)));
     }
     if (!bus->is_roundtrip)  {
         for (int i = static_cast<int>(bus->stops.size() - 2); i >= 0; --i) {
-            route.AddPoint(proj(bus->stops[i]->coordinates));
+            route.AddPoint(proj(db.GetStopCoordinates(bus->stops[i])));
         }
     }
     route.SetFillColor("none")
@@ -82,7 +86,7 @@ svg::Text MapRenderer::RenderBusNameUnderlayer(const Bus* bus, svg::Point pos) c
                 .SetFontSize(render_settings_.bus_label_font_size)
                 .SetFontFamily("Verdana"s)
                 .SetFontWeight("bold"s)
-                .SetData(bus->name);
+                .SetData(std::string(bus->name));
     name_underlayer.SetFillColor(render_settings_.underlayer_color)
                 .SetStrokeColor(render_settings_.underlayer_color)
                 .SetStrokeWidth(render_settings_.underlayer_width)
@@ -97,7 +101,7 @@ svg::Text MapRenderer::RenderStopNameUnderlayer(const Stop* stop, svg::Point pos
                 .SetOffset(render_settings_.stop_label_offset)
                 .SetFontSize(render_settings_.stop_label_font_size)
                 .SetFontFamily("Verdana"s)
-                .SetData(stop->name);
+                .SetData(std::string(stop->name));
     name_underlayer.SetFillColor(render_settings_.underlayer_color)
                 .SetStrokeColor(render_settings_.underlayer_color)
                 .SetStrokeWidth(render_settings_.underlayer_width)
@@ -113,7 +117,7 @@ svg::Text MapRenderer::RenderBusName(const Bus* bus, svg::Point pos, int color_n
                 .SetFontSize(render_settings_.bus_label_font_size)
                 .SetFontFamily("Verdana"s)
                 .SetFontWeight("bold"s)
-                .SetData(bus->name);
+                .SetData(std::string(bus->name));
     route_name.SetFillColor(render_settings_.color_palette[color_num % render_settings_.color_palette.size()]);
     return route_name;
 }
@@ -124,7 +128,7 @@ svg::Text MapRenderer::RenderStopName(const Stop* stop, svg::Point pos) const {
                 .SetOffset(render_settings_.stop_label_offset)
                 .SetFontSize(render_settings_.stop_label_font_size)
                 .SetFontFamily("Verdana"s)
-                .SetData(stop->name)
+                .SetData(std::string(stop->name))
                 .SetFillColor("black"s);
     return stop_name;
 }
@@ -99,7 +99,7 @@ class MapRenderer {
 public:
     MapRenderer();
     
-    svg::Document RenderMap(const std::map<std::string_view, const Bus*>& buses) const;
+    svg::Document RenderMap(const TransportCatalogue& db) const;
     
     svg::Color SetColor(const json::Node& raw_color);
     
@@ -108,7 +108,7 @@ public:
     RenderSettings GetSettings() const;
     
 private:
-    svg::Polyline RenderBusRoute(SphereProjector& proj, const Bus* bus, int color_num) const;
+    svg::Polyline RenderBusRoute(SphereProjector& proj, const TransportCatalogue& db, const Bus* bus, int color_num) const;
     
     svg::Text RenderBusNameUnderlayer(const Bus* bus, svg::Point pos) const;
     svg::Text RenderStopNameUnderlayer(const Stop* stop, svg::Point pos) const;
@@ -0,0 +1,236 @@
+#include "raptor_router.h"
+
+namespace catalogue {
+
+RaptorRouter::RaptorRouter(const TransportCatalogue& db, int bus_wait_time, double bus_velocity)
+    : profile_{static_cast<double>(bus_wait_time), bus_velocity}
+{
+    stops_.reserve(db.GetStopsCount());
+    for (StopId stop = 0; stop < db.GetStopsCount(); ++stop) {
+        stops_.push_back(db.GetStopById(stop));
+    }
+    for (const Bus* bus_ptr : db.GetAllBuses()) {
+        if (bus_ptr->stops.size() < 2) {
+            continue;
+        }
+        AddPattern(db, bus_ptr, {bus_ptr->stops.begin(), bus_ptr->stops.end()});
+        if (!bus_ptr->is_roundtrip) {
+            AddPattern(db, bus_ptr, {bus_ptr->stops.rbegin(), bus_ptr->stops.rend()});
+        }
+    }
+    IndexPatternStops();
+    ComputeComponents();
+}
+
+void RaptorRouter::AddPattern(const TransportCatalogue& db, const Bus* bus, std::vector<StopId> stops) {
+    Pattern pattern;
+    pattern.bus = bus;
+    pattern.stops.reserve(stops.size());
+    pattern.distances.reserve(stops.size());
+    double distance = 0;
+    for (size_t position = 0; position < stops.size(); ++position) {
+        if (position != 0) {
+            distance += db.GetKnownDistance(stops[position - 1], stops[position]);
+        }
+        pattern.stops.push_back(stops[position]);
+        pattern.distances.push_back(distance);
+    }
+    patterns_.push_back(std::move(pattern));
+}
+
+void RaptorRouter::IndexPatternStops() {
+    stop_pattern_offsets_.assign(stops_.size() + 1, 0);
+    for (const Pattern& pattern : patterns_) {
+        for (const size_t stop : pattern.stops) {
+            ++stop_pattern_offsets_[stop + 1];
+        }
+    }
+    for (size_t stop = 0; stop < stops_.size(); ++stop) {
+        stop_pattern_offsets_[stop + 1] += stop_pattern_offsets_[stop];
+    }
+    stop_patterns_.resize(stop_pattern_offsets_.back());
+    std::vector<size_t> positions(stop_pattern_offsets_.begin(), stop_pattern_offsets_.end() - 1);
+    for (size_t pattern_index = 0; pattern_index < patterns_.size(); ++pattern_index) {
+        const Pattern& pattern = patterns_[pattern_index];
+        for (size_t position = 0; position < pattern.stops.size(); ++position) {
+            stop_patterns_[positions[pattern.stops[position]]++] = {pattern_index, position};
+        }
+    }
+}
+
+void RaptorRouter::ComputeComponents() {
+    // Поездки между соседними остановками задают ту же достижимость, что и все поездки прохода
+    std::vector<graph::CsrGraph<double>::Arc> arcs;
+    for (const Pattern& pattern : patterns_) {
+        for (size_t position = 0; position + 1 < pattern.stops.size(); ++position) {
+            arcs.push_back({static_cast<graph::VertexId>(pattern.stops[position]),
+                            static_cast<graph::VertexId>(pattern.stops[position + 1]), 0.0, arcs.size()});
+        }
+    }
+    components_ = graph::ComputeGraphComponents(graph::CsrGraph<double>(stops_.size(), arcs));
+}
+
+double RaptorRouter::GetRideTime(const Pattern& pattern, size_t board_position, size_t alight_position,
+                                 const RoutingProfile& profile) {
+    const double velocity = profile.velocity * (1000 / 60.0); // скорость в м/мин
+    return (pattern.distances[alight_position] - pattern.distances[board_position]) / velocity;
+}
+
+std::optional<RouteItems> RaptorRouter::GetRoute(const Stop* start_stop, const Stop* finish_stop,
+                                                 graph::SearchStats* stats) const {
+    return GetRoute(start_stop, finish_stop, profile_, stats);
+}
+
+std::optional<RouteItems> RaptorRouter::GetRoute(const Stop* start_stop, const Stop* finish_stop,
+                                                 const RoutingProfile& profile, graph::SearchStats* stats) const {
+    const size_t start = start_stop->id;
+    const size_t finish = finish_stop->id;
+    if (components_.IsUnreachable(start, finish)) {
+        if (stats != nullptr) {
+            *stats = {};
+        }
+        return std::nullopt;
+    }
+    const SearchResult result = Search(start, finish, profile);
+    if (stats != nullptr) {
+        stats->settled_vertices = result.settled_count;
+    }
+    return RestoreRoute(result, finish, true, profile);
+}
+
+std::vector<std::optional<RouteItems>> RaptorRouter::GetRoutesFrom(const Stop* start_stop,
+                                                                   const std::vector<const Stop*>& finish_stops,
+                                                                   bool with_items) const {
+    const SearchResult result = Search(start_stop->id, NO_STOP, profile_);
+    std::vector<std::optional<RouteItems>> routes;
+    routes.reserve(finish_stops.size());
+    for (const Stop* finish_stop : finish_stops) {
+        routes.push_back(RestoreRoute(result, finish_stop->id, with_items, profile_));
+    }
+    return routes;
+}
+
+std::vector<std::pair<const Stop*, double>> RaptorRouter::GetReachableStops(const Stop* start_stop, double max_time) const {
+    std::vector<std::pair<const Stop*, double>> reachable_stops;
+    if (max_time < 0) {
+        return reachable_stops;
+    }
+    const SearchResult result = Search(start_stop->id, NO_STOP, profile_, max_time);
+    for (size_t stop = 0; stop < stops_.size(); ++stop) {
+        if (result.arrivals[stop] <= max_time) {
+            reachable_stops.push_back({stops_[stop], result.arrivals[stop]});
+        }
+    }
+    std::sort(reachable_stops.begin(), reachable_stops.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.second < rhs.second;
+    });
+    return reachable_stops;
+}
+
+RaptorRouter::SearchResult RaptorRouter::Search(size_t start, size_t finish, const RoutingProfile& profile,
+                                                double max_arrival) const {
+    const double infinity = std::numeric_limits<double>::infinity();
+    SearchResult result;
+    result.arrivals.assign(stops_.size(), infinity);
+    result.last_labels.assign(stops_.size(), NO_LABEL);
+    auto& arrivals = result.arrivals;
+    // Метки предыдущего раунда: по ним выбирается посадка в текущем
+    std::vector<double> previous_arrivals(stops_.size(), infinity);
+    std::vector<bool> is_marked(stops_.size(), false);
+    std::vector<size_t> marked_stops{start};
+    // Самая ранняя позиция отмеченной остановки в каждом проходе текущего раунда
+    std::vector<size_t> first_positions(patterns_.size(), NO_PATTERN);
+    std::vector<size_t> patterns_to_scan;
+    arrivals[start] = 0;
+    previous_arrivals[start] = 0;
+
+    for (size_t round = 1; !marked_stops.empty(); ++round) {
+        for (const size_t stop : marked_stops) {
+            is_marked[stop] = false;
+            ++result.settled_count;
+            for (size_t index = stop_pattern_offsets_[stop]; index < stop_pattern_offsets_[stop + 1]; ++index) {
+                const auto [pattern_index, position] = stop_patterns_[index];
+                if (first_positions[pattern_index] == NO_PATTERN) {
+                    patterns_to_scan.push_back(pattern_index);
+                    first_positions[pattern_index] = position;
+                } else {
+                    first_positions[pattern_index] = std::min(first_positions[pattern_index], position);
+                }
+            }
+        }
+        marked_stops.clear();
+
+        for (const size_t pattern_index : patterns_to_scan) {
+            const Pattern& pattern = patterns_[pattern_index];
+            size_t board_position = NO_PATTERN;
+            // Время отправления с остановки посадки с учётом ожидания
+            double departure = infinity;
+            for (size_t position = first_positions[pattern_index]; position < pattern.stops.size(); ++position) {
+                const size_t stop = pattern.stops[position];
+                double arrival = infinity;
+                if (board_position != NO_PATTERN) {
+                    arrival = departure + GetRideTime(pattern, board_position, position, profile);
+                    // Прибытия не раньше уже найденного до конечной остановки не могут улучшить ответ
+                    if (arrival < arrivals[stop] && arrival <= max_arrival
+                        && (finish == NO_STOP || arrival < arrivals[finish])) {
+                        arrivals[stop] = arrival;
+                        result.labels.push_back({round, {pattern_index, board_position, position},
+                                                 result.last_labels[stop]});
+                        result.last_labels[stop] = result.labels.size() - 1;
+                        if (!is_marked[stop]) {
+                            is_marked[stop] = true;
+                            marked_stops.push_back(stop);
+                        }
+                    }
+                }
+                // Сесть на этот проход здесь выгоднее, если по меткам прошлого раунда отсюда можно
+                // отправиться раньше, чем проехать остановку
+                if (previous_arrivals[stop] + profile.time < arrival) {
+                    board_position = position;
+                    departure = previous_arrivals[stop] + profile.time;
+                }
+            }
+            first_positions[pattern_index] = NO_PATTERN;
+        }
+        patterns_to_scan.clear();
+        for (const size_t stop : marked_stops) {
+            previous_arrivals[stop] = arrivals[stop];
+        }
+    }
+    return result;
+}
+
+std::optional<RouteItems> RaptorRouter::RestoreRoute(const SearchResult& result, size_t finish, bool with_items,
+                                                     const RoutingProfile& profile) const {
+    if (result.arrivals[finish] == std::numeric_limits<double>::infinity()) {
+        return std::nullopt;
+    }
+    RouteItems items_info;
+    items_info.total_time = result.arrivals[finish];
+    if (!with_items) {
+        return items_info;
+    }
+    // Посадка поездки раунда k была по метке остановки из раунда не позже k - 1
+    for (size_t label = result.last_labels[finish]; label != NO_LABEL;) {
+        const Ride& ride = result.labels[label].ride;
+        const size_t round = result.labels[label].round;
+        const Pattern& pattern = patterns_[ride.pattern];
+        const size_t board_stop = pattern.stops[ride.board_position];
+        items_info.items.push_back({ItemType::BUS,
+                                    pattern.bus->name,
+                                    GetRideTime(pattern, ride.board_position, ride.alight_position, profile),
+                                    static_cast<int>(ride.alight_position - ride.board_position),
+                                    pattern.bus->id,
+                                    pattern.distances[ride.alight_position] - pattern.distances[ride.board_position]});
+        items_info.items.push_back({ItemType::WAIT, stops_[board_stop]->name, profile.time, 1,
+                                    stops_[board_stop]->id});
+        label = result.last_labels[board_stop];
+        while (label != NO_LABEL && result.labels[label].round >= round) {
+            label = result.labels[label].previous;
+        }
+    }
+    std::reverse(items_info.items.begin(), items_info.items.end());
+    return items_info;
+}
+
+} // namespace catalogue
@@ -0,0 +1,95 @@
+#pragma once
+#include "transport_router.h"
+
+namespace catalogue {
+
+// Поиск маршрутов раундами по последовательностям остановок автобусов (RAPTOR): метки раунда k — лучшие
+// времена прибытия не более чем с k поездками. В раунде k просматриваются проходы через остановки, улучшенные
+// в раунде k - 1, а садиться на них можно только по меткам раунда k - 1, так что каждый раунд добавляет одну поездку.
+// Граф с рёбрами между всеми парами остановок маршрута не строится — память и время
+// подготовки линейны по суммарной длине маршрутов
+class RaptorRouter {
+public:
+    RaptorRouter(const TransportCatalogue& db, int bus_wait_time, double bus_velocity);
+
+    // Если передан stats, settled_vertices — число обработанных отмеченных остановок
+    std::optional<RouteItems> GetRoute(const Stop* start_stop, const Stop* finish_stop,
+                                       graph::SearchStats* stats = nullptr) const;
+
+    // Маршрут по другому профилю: время поездок пересчитывается по расстояниям во время поиска
+    std::optional<RouteItems> GetRoute(const Stop* start_stop, const Stop* finish_stop, const RoutingProfile& profile,
+                                       graph::SearchStats* stats = nullptr) const;
+
+    // Маршруты из start_stop во все finish_stops за один поиск; без with_items заполняется только total_time
+    std::vector<std::optional<RouteItems>> GetRoutesFrom(const Stop* start_stop,
+                                                         const std::vector<const Stop*>& finish_stops,
+                                                         bool with_items) const;
+
+    // Остановки, достижимые не дольше чем за max_time, в порядке возрастания времени в пути
+    std::vector<std::pair<const Stop*, double>> GetReachableStops(const Stop* start_stop, double max_time) const;
+
+private:
+    // Проход автобуса по остановкам в одном направлении
+    struct Pattern {
+        const Bus* bus;
+        std::vector<size_t> stops;
+        // Расстояние от начала прохода до каждой остановки
+        std::vector<double> distances;
+    };
+
+    // Последняя поездка на пути к остановке
+    struct Ride {
+        size_t pattern;
+        size_t board_position;
+        size_t alight_position;
+    };
+
+    // Улучшение времени прибытия на остановку в раунде round; previous — предыдущее улучшение той же остановки
+    struct Label {
+        size_t round;
+        Ride ride;
+        size_t previous;
+    };
+
+    struct SearchResult {
+        // Наименьшее время прибытия на остановку до ожидания автобуса по всем раундам
+        std::vector<double> arrivals;
+        // Все улучшения в порядке появления и последнее улучшение каждой остановки
+        std::vector<Label> labels;
+        std::vector<size_t> last_labels;
+        size_t settled_count = 0;
+    };
+
+    static constexpr size_t NO_PATTERN = std::numeric_limits<size_t>::max();
+    static constexpr size_t NO_STOP = std::numeric_limits<size_t>::max();
+    static constexpr size_t NO_LABEL = std::numeric_limits<size_t>::max();
+
+    // Поиск из start; если finish != NO_STOP, отсекаются прибытия не раньше найденного до finish.
+    // Прибытия позже max_arrival отсекаются всегда
+    SearchResult Search(size_t start, size_t finish, const RoutingProfile& profile,
+                        double max_arrival = std::numeric_limits<double>::infinity()) const;
+
+    std::optional<RouteItems> RestoreRoute(const SearchResult& result, size_t finish, bool with_items,
+                                           const RoutingProfile& profile) const;
+
+    void AddPattern(const TransportCatalogue& db, const Bus* bus, std::vector<StopId> stops);
+
+    void IndexPatternStops();
+
+    void ComputeComponents();
+
+    static double GetRideTime(const Pattern& pattern, size_t board_position, size_t alight_position,
+                              const RoutingProfile& profile);
+
+    RoutingProfile profile_;
+    // Остановки по номерам каталога: номер остановки служит её индексом во всех массивах поиска
+    std::vector<const Stop*> stops_;
+    std::vector<Pattern> patterns_;
+    // Для каждой остановки — пары (проход, позиция в проходе), подряд по остановкам
+    std::vector<size_t> stop_pattern_offsets_;
+    std::vector<std::pair<size_t, size_t>> stop_patterns_;
+    // Компоненты связности графа поездок между соседними остановками проходов
+    graph::GraphComponents components_;
+};
+
+} // namespace catalogue
@@ -1,5 +1,7 @@
 #include "request_handler.h"
 
+#include <algorithm>
+
 namespace catalogue {
 namespace handler {
 
@@ -28,6 +30,8 @@ void RequestHandler::MakeBase(TransportCatalogue& catalogue,
             json_rd_.SetSerializationSettings(serializer, requests);
         }
     }
+    catalogue.ComputeBusStats(router.GetSettings().thread_count);
+    router.BuildAllRoutes();
     serializer.SerializeBase();
 }
 
@@ -40,34 +44,93 @@ void RequestHandler::ProcessRequests(TransportCatalogue& catalogue,
     for (const auto& [type, requests] : input_requests.GetRoot().AsDict()) {
         if (type == "stat_requests") {
             serializer.DeserializeBase();
-            router.BuildAllRoutes();
-            MakeResponse(out, requests);
+            // Маршрутизатор восстанавливается, только если он понадобится для ответа,
+            // и в фоне, пока отвечаем на запросы к каталогу и карте
+            std::future<void> router_ready;
+            if (HasRoutingRequests(requests)) {
+                router_ready = std::async(std::launch::async, [&serializer] { serializer.DeserializeRouter(); });
+            }
+            MakeResponse(out, requests, std::move(router_ready));
         } else if (type == "serialization_settings"){
             json_rd_.SetSerializationSettings(serializer, requests);
         }
     }
 }
     
-void RequestHandler::MakeResponse(std::ostream& out, const json::Node& stat_requests) {
-    json::Array requests_array = stat_requests.AsArray();
-    if (stat_requests.AsArray().empty()) { return; }
+bool RequestHandler::HasRoutingRequests(const json::Node& stat_requests) {
+    for (const auto& element : stat_requests.AsArray()) {
+        if (NeedsRouter(element.AsDict().at("type").AsString())) {
+            return true;
+        }
+    }
+    return false;
+}
     
-    json::Builder builder;
-    builder.StartArray();
-    for (const auto& element : requests_array) {
-        json::Dict request = element.AsDict();
-        if (request["type"].AsString() == "Bus") {
-            BuildBusStat(builder, request["id"].AsInt(), GetBusStat(request["name"].AsString()));
-        } else if (request["type"].AsString() == "Stop") {
-            BuildStopInfo(builder, request["id"].AsInt(), GetBusesByStop(request["name"].AsString()));
-        } else if (request["type"].AsString() == "Map") {
-            BuildRenderredMap(builder, request["id"].AsInt(), PrintMap());
-        } else if (request["type"].AsString() == "Route") {
-            BuildRoutes(builder, request["id"].AsInt(), GetRouteByStops(request["from"].AsString(), request["to"].AsString()));
+bool RequestHandler::NeedsRouter(std::string_view type) {
+    return type == "Route" || type == "RouteTime" || type == "RouteMatrix" || type == "Isochrone"
+        || type == "RouteCacheStats" || type == "UpdateRouter";
+}
+    
+bool RequestHandler::DependsOnRouter(std::string_view type) {
+    return NeedsRouter(type) || type == "RouterStatus";
+}
+    
+void RequestHandler::MakeResponse(std::ostream& out, const json::Node& stat_requests, std::future<void> router_ready) {
+    const json::Array& requests_array = stat_requests.AsArray();
+    if (requests_array.empty()) { return; }
+    
+    // Сначала отвечаем на запросы, не зависящие от маршрутизатора, затем дожидаемся его
+    // и отвечаем на остальные по порядку; ответы раскладываются по местам запросов
+    std::vector<std::optional<json::Node>> responses(requests_array.size());
+    for (size_t i = 0; i < requests_array.size(); ++i) {
+        if (!DependsOnRouter(requests_array[i].AsDict().at("type").AsString())) {
+            responses[i] = MakeRequestResponse(requests_array[i].AsDict());
         }
     }
-    builder.EndArray();
-    json::Print(json::Document{builder.Build()}, out);
+    if (router_ready.valid()) {
+        router_ready.get();
+    }
+    for (size_t i = 0; i < requests_array.size(); ++i) {
+        if (DependsOnRouter(requests_array[i].AsDict().at("type").AsString())) {
+            responses[i] = MakeRequestResponse(requests_array[i].AsDict());
+        }
+    }
+    json::Array responses_array;
+    for (auto& response : responses) {
+        if (response) {
+            responses_array.push_back(std::move(*response));
+        }
+    }
+    json::Print(json::Document{json::Node{std::move(responses_array)}}, out);
+}
+    
+std::optional<json::Node> RequestHandler::MakeRequestResponse(json::Dict request) {
+    json::Builder builder;
+    if (request["type"].AsString() == "Bus") {
+        BuildBusStat(builder, request["id"].AsInt(), GetBusStat(request["name"].AsString()));
+    } else if (request["type"].AsString() == "Stop") {
+        BuildStopInfo(builder, request["id"].AsInt(), GetBusesByStop(request["name"].AsString()));
+    } else if (request["type"].AsString() == "Map") {
+        BuildRenderredMap(builder, request["id"].AsInt(), PrintMap());
+    } else if (request["type"].AsString() == "Route") {
+        BuildRouteByRequest(builder, request);
+    } else if (request["type"].AsString() == "RouteTime") {
+        BuildRouteTime(builder, request["id"].AsInt(), request["from"].AsString(), request["to"].AsString());
+    } else if (request["type"].AsString() == "RouteMatrix") {
+        const bool with_items = request.count("with_items") != 0 && request.at("with_items").AsBool();
+        BuildRouteMatrix(builder, request["id"].AsInt(), request["from"].AsArray(), request["to"].AsArray(), with_items);
+    } else if (request["type"].AsString() == "Isochrone") {
+        BuildIsochrone(builder, request["id"].AsInt(), request["from"].AsString(), request["max_time"].AsDouble());
+    } else if (request["type"].AsString() == "RouteCacheStats") {
+        BuildRouteCacheStats(builder, request["id"].AsInt());
+    } else if (request["type"].AsString() == "UpdateRouter") {
+        BuildRouterUpdate(builder, request);
+    } else if (request["type"].AsString() == "RouterStatus") {
+        BuildRouterStatus(builder, request["id"].AsInt());
+    } else {
+        return std::nullopt;
+    }
+    return builder.Build();
 }
 
 void RequestHandler::BuildBusStat(json::Builder& builder, int request_id, const std::optional<BusStat>& bus_stat) {
@@ -88,13 +151,13 @@ void RequestHandler::BuildBusStat(json::Builder& builder, int request_id, const
     }
 }
 
-void RequestHandler::BuildStopInfo(json::Builder& builder, int request_id, const Buses& buses) {
+void RequestHandler::BuildStopInfo(json::Builder& builder, int request_id, Buses buses) {
     using namespace std::literals;
-    if (buses) {
+    if (buses != nullptr) {
         builder.StartDict();
         builder.Key("buses"s);
         builder.StartArray();
-        for (const auto& bus : buses.value()) {
+        for (const auto& bus : *buses) {
             builder.Value(std::string(bus));
         }
         builder.EndArray();
@@ -140,30 +203,267 @@ void RequestHandler::InsertRouteItem(json::Builder& builder,const Item& item) {
     }
 }
     
-void RequestHandler::BuildRoutes(json::Builder& builder, int request_id, const std::optional<RouteItems>& items) {
+void RequestHandler::BuildRoutes(json::Builder& builder, int request_id, std::optional<double> total_time,
+                                 const std::vector<Item>& items, const graph::SearchStats* stats) {
     using namespace std::literals;
-    if (items) {
+    if (total_time) {
         builder.StartDict()
             .Key("request_id").Value(request_id)
-            .Key("total_time").Value(items.value().total_time)
+            .Key("total_time").Value(*total_time)
             .Key("items")
             .StartArray();
-        for (const auto& item : items.value().items) {
+        for (const auto& item : items) {
             InsertRouteItem(builder, item);
         }
         builder.EndArray();
-        builder.EndDict();
     } else {
+        builder.StartDict()
+                    .Key("request_id"s).Value(request_id)
+                    .Key("error_message"s).Value("not found"s);
+    }
+    if (stats != nullptr) {
+        builder.Key("settled_vertices"s).Value(static_cast<int>(stats->settled_vertices));
+    }
+    builder.EndDict();
+}
+    
+void RequestHandler::BuildRouteByRequest(json::Builder& builder, const json::Dict& request) {
+    using namespace std::literals;
+    const int request_id = request.at("id").AsInt();
+    const bool with_stats = request.count("with_stats") != 0 && request.at("with_stats").AsBool();
+    std::optional<RoutingProfile> profile;
+    if (request.count("profile") != 0) {
+        const RoutingProfile* named_profile = router_.FindProfile(request.at("profile").AsString());
+        if (named_profile == nullptr) {
+            builder.StartDict()
+                        .Key("request_id"s).Value(request_id)
+                        .Key("error_message"s).Value("unknown profile"s)
+                    .EndDict();
+            return;
+        }
+        profile = *named_profile;
+    }
+    if (request.count("bus_wait_time") != 0 || request.count("bus_velocity") != 0) {
+        if (!profile) {
+            const RouterSettings settings = router_.GetSettings();
+            profile = RoutingProfile{static_cast<double>(settings.time), settings.velocity};
+        }
+        if (request.count("bus_wait_time") != 0) {
+            profile->time = request.at("bus_wait_time").AsDouble();
+        }
+        if (request.count("bus_velocity") != 0) {
+            profile->velocity = request.at("bus_velocity").AsDouble();
+        }
+    }
+    
+    graph::SearchStats stats;
+    const std::string& from = request.at("from").AsString();
+    const std::string& to = request.at("to").AsString();
+    std::optional<double> total_time;
+    if (profile) {
+        route_buffer_.items.clear();
+        const Stop* start_stop = db_.GetStop(from);
+        const Stop* finish_stop = db_.GetStop(to);
+        if (start_stop == nullptr || finish_stop == nullptr) {
+            BuildRoutes(builder, request_id, std::nullopt, route_buffer_.items, with_stats ? &stats : nullptr);
+            return;
+        }
+        total_time = router_.GetRoute(start_stop, finish_stop, *profile, route_buffer_, &stats);
+    } else {
+        total_time = GetRouteByStops(from, to, route_buffer_, with_stats ? &stats : nullptr);
+    }
+    BuildRoutes(builder, request_id, total_time, route_buffer_.items, with_stats ? &stats : nullptr);
+}
+    
+void RequestHandler::BuildRouteTime(json::Builder& builder, int request_id, std::string_view from, std::string_view to) {
+    using namespace std::literals;
+    const Stop* start_stop = db_.GetStop(from);
+    const Stop* finish_stop = db_.GetStop(to);
+    const std::optional<double> total_time = start_stop != nullptr && finish_stop != nullptr
+                                           ? router_.GetRouteTime(start_stop, finish_stop)
+                                           : std::nullopt;
+    builder.StartDict()
+        .Key("request_id"s).Value(request_id);
+    if (total_time) {
+        builder.Key("total_time"s).Value(*total_time);
+    } else {
+        builder.Key("error_message"s).Value("not found"s);
+    }
+    builder.EndDict();
+}
+    
+void RequestHandler::BuildRouteMatrix(json::Builder& builder, int request_id, const json::Array& from, const json::Array& to,
+                                      bool with_items) {
+    using namespace std::literals;
+    const auto get_stops = [this](const json::Array& stop_names) {
+        std::vector<const Stop*> stops;
+        stops.reserve(stop_names.size());
+        for (const auto& stop_name : stop_names) {
+            stops.push_back(db_.GetStop(stop_name.AsString()));
+        }
+        return stops;
+    };
+    const std::vector<const Stop*> start_stops = get_stops(from);
+    const std::vector<const Stop*> finish_stops = get_stops(to);
+    const auto is_missing = [](const Stop* stop) { return stop == nullptr; };
+    if (std::any_of(start_stops.begin(), start_stops.end(), is_missing)
+        || std::any_of(finish_stops.begin(), finish_stops.end(), is_missing)) {
+        builder.StartDict()
+                    .Key("request_id"s).Value(request_id)
+                    .Key("error_message"s).Value("not found"s)
+                .EndDict();
+        return;
+    }
+    const std::vector<std::vector<std::optional<RouteItems>>> matrix = router_.GetRouteMatrix(start_stops, finish_stops,
+                                                                                                 with_items);
+    
+    builder.StartDict()
+        .Key("request_id"s).Value(request_id)
+        .Key("total_times"s).StartArray();
+    for (const auto& row : matrix) {
+        builder.StartArray();
+        for (const auto& route : row) {
+            if (route) {
+                builder.Value(route->total_time);
+            } else {
+                builder.Value(nullptr);
+            }
+        }
+        builder.EndArray();
+    }
+    builder.EndArray();
+    if (with_items) {
+        builder.Key("items"s).StartArray();
+        for (const auto& row : matrix) {
+            builder.StartArray();
+            for (const auto& route : row) {
+                if (!route) {
+                    builder.Value(nullptr);
+                    continue;
+                }
+                builder.StartArray();
+                for (const auto& item : route->items) {
+                    InsertRouteItem(builder, item);
+                }
+                builder.EndArray();
+            }
+            builder.EndArray();
+        }
+        builder.EndArray();
+    }
+    builder.EndDict();
+}
+    
+void RequestHandler::BuildIsochrone(json::Builder& builder, int request_id, std::string_view stop_name, double max_time) {
+    using namespace std::literals;
+    const Stop* start_stop = db_.GetStop(stop_name);
+    if (start_stop == nullptr) {
+        builder.StartDict()
+                    .Key("request_id"s).Value(request_id)
+                    .Key("error_message"s).Value("not found"s)
+                .EndDict();
+        return;
+    }
+    builder.StartDict()
+        .Key("request_id"s).Value(request_id)
+        .Key("stops"s).StartArray();
+    for (const auto& [stop_ptr, time] : router_.GetReachableStops(start_stop, max_time)) {
+        builder.StartDict()
+                .Key("stop_name"s).Value(std::string(stop_ptr->name))
+                .Key("time"s).Value(time)
+            .EndDict();
+    }
+    builder.EndArray();
+    builder.EndDict();
+}
+    
+void RequestHandler::BuildRouterUpdate(json::Builder& builder, const json::Dict& request) {
+    using namespace std::literals;
+    const int request_id = request.at("id").AsInt();
+    std::vector<std::pair<const Stop*, bool>> stop_updates;
+    std::vector<std::pair<const Bus*, double>> bus_updates;
+    bool is_found = true;
+    const auto add_stops = [this, &request, &stop_updates, &is_found](const std::string& key, bool closed) {
+        if (request.count(key) == 0) { return; }
+        for (const auto& stop_name : request.at(key).AsArray()) {
+            const Stop* stop = db_.GetStop(stop_name.AsString());
+            is_found = is_found && stop != nullptr;
+            stop_updates.push_back({stop, closed});
+        }
+    };
+    add_stops("close_stops"s, true);
+    add_stops("open_stops"s, false);
+    if (request.count("bus_time_factors") != 0) {
+        for (const auto& [bus_name, time_factor] : request.at("bus_time_factors").AsDict()) {
+            const Bus* bus = db_.GetBus(bus_name);
+            is_found = is_found && bus != nullptr;
+            bus_updates.push_back({bus, time_factor.AsDouble()});
+        }
+    }
+    if (request.count("disable_buses") != 0) {
+        for (const auto& bus_name : request.at("disable_buses").AsArray()) {
+            const Bus* bus = db_.GetBus(bus_name.AsString());
+            is_found = is_found && bus != nullptr;
+            bus_updates.push_back({bus, std::numeric_limits<double>::infinity()});
+        }
+    }
+    if (!is_found) {
         builder.StartDict()
                     .Key("request_id"s).Value(request_id)
                     .Key("error_message"s).Value("not found"s)
                 .EndDict();
+        return;
+    }
+    if (router_.GetSettings().mode == RouterMode::RAPTOR) {
+        builder.StartDict()
+                    .Key("request_id"s).Value(request_id)
+                    .Key("error_message"s).Value("not supported"s)
+                .EndDict();
+        return;
     }
+    
+    for (const auto& [stop, closed] : stop_updates) {
+        router_.SetStopClosed(stop, closed);
+    }
+    for (const auto& [bus, time_factor] : bus_updates) {
+        router_.SetBusTimeFactor(bus, time_factor);
+    }
+    builder.StartDict()
+            .Key("request_id"s).Value(request_id)
+            .Key("changed_edges"s).Value(static_cast<int>(router_.GetChangedEdgeCount()))
+        .EndDict();
+}
+    
+void RequestHandler::BuildRouterStatus(json::Builder& builder, int request_id) {
+    using namespace std::literals;
+    builder.StartDict()
+            .Key("request_id"s).Value(request_id)
+            .Key("router_loaded"s).Value(serializer_.IsRouterDeserialized())
+        .EndDict();
+}
+    
+void RequestHandler::BuildRouteCacheStats(json::Builder& builder, int request_id) {
+    using namespace std::literals;
+    const std::optional<RouteCacheStats> cache_stats = router_.GetRouteCacheStats();
+    if (!cache_stats) {
+        builder.StartDict()
+                    .Key("request_id"s).Value(request_id)
+                    .Key("error_message"s).Value("route cache is disabled"s)
+                .EndDict();
+        return;
+    }
+    builder.StartDict()
+            .Key("request_id"s).Value(request_id)
+            .Key("hits"s).Value(static_cast<int>(cache_stats->hits))
+            .Key("misses"s).Value(static_cast<int>(cache_stats->misses))
+            .Key("evictions"s).Value(static_cast<int>(cache_stats->evictions))
+            .Key("size_bytes"s).Value(static_cast<int>(cache_stats->size_bytes))
+        .EndDict();
 }
     
 std::ostringstream RequestHandler::PrintMap() const {
     std::ostringstream svg;
-    svg::Document doc = renderer_.RenderMap(db_.GetAllBuses());
+    svg::Document doc = renderer_.RenderMap(db_);
     doc.Render(svg);
     return svg;
 }
@@ -179,8 +479,15 @@ Buses RequestHandler::GetBusesByStop(std::string_view stop) const {
     return db_.GetBusesByStop(stop);
 }
     
-std::optional<RouteItems> RequestHandler::GetRouteByStops(std::string_view start_stop, std::string_view finish_stop) const {
-    return router_.GetRoute(db_.GetStop(start_stop), db_.GetStop(finish_stop));
+std::optional<double> RequestHandler::GetRouteByStops(std::string_view start_stop, std::string_view finish_stop,
+                                                     RouteBuffer& buffer, graph::SearchStats* stats) const {
+    const Stop* start_stop_ptr = db_.GetStop(start_stop);
+    const Stop* finish_stop_ptr = db_.GetStop(finish_stop);
+    if (start_stop_ptr == nullptr || finish_stop_ptr == nullptr) {
+        buffer.items.clear();
+        return std::nullopt;
+    }
+    return router_.GetRoute(start_stop_ptr, finish_stop_ptr, buffer, stats);
 }
     
 } // namespace handler
@@ -4,6 +4,8 @@
 #include "map_renderer.h"
 #include "serialization.h"
 
+#include <future>
+
 namespace catalogue {
 namespace handler {
     
@@ -31,19 +33,62 @@ public:
                     TransportRouter& router,
                     Serializer& serializer);
     
-    void MakeResponse(std::ostream& out, const json::Node& stat_requests);
+    // Есть ли среди запросов те, для ответа на которые нужен маршрутизатор
+    static bool HasRoutingRequests(const json::Node& stat_requests);
+    
+    // Запросы, для ответа на которые маршрутизатор загружается
+    static bool NeedsRouter(std::string_view type);
+    
+    // Запросы, ответ на которые зависит от состояния маршрутизатора: те, которым он нужен, и RouterStatus,
+    // который сообщает, загружен ли маршрутизатор, но сам его загрузку не вызывает
+    static bool DependsOnRouter(std::string_view type);
+    
+    // Если передан router_ready, запросы к каталогу и карте обрабатываются, не дожидаясь его,
+    // а зависящие от маршрутизатора — после его готовности. Порядок ответов совпадает с порядком запросов
+    void MakeResponse(std::ostream& out, const json::Node& stat_requests, std::future<void> router_ready = {});
+    
+    // Ответ на один запрос; std::nullopt — тип запроса не поддерживается
+    std::optional<json::Node> MakeRequestResponse(json::Dict request);
     
     void ReadJSON(std::istream& input, std::ostream& out);
     
     void BuildBusStat(json::Builder& builder, int request_id, const std::optional<BusStat>& bus_stat);
     
-    void BuildStopInfo(json::Builder& builder, int request_id, const Buses& buses);
+    void BuildStopInfo(json::Builder& builder, int request_id, Buses buses);
     
     void BuildRenderredMap(json::Builder& builder, int request_id, const std::ostringstream& map);
     
     void InsertRouteItem(json::Builder& builder, const Item& item);
     
-    void BuildRoutes(json::Builder& builder, int request_id, const std::optional<RouteItems>& items);
+    // Если передан stats, добавляет в ответ число вершин, просмотренных при поиске
+    void BuildRoutes(json::Builder& builder, int request_id, std::optional<double> total_time,
+                     const std::vector<Item>& items, const graph::SearchStats* stats = nullptr);
+    
+    // Ответ на запрос Route. Профиль маршрутизации задаётся именем из настроек (profile)
+    // и/или полями bus_wait_time и bus_velocity запроса; без них используется основной профиль
+    void BuildRouteByRequest(json::Builder& builder, const json::Dict& request);
+    
+    // Время в пути между остановками без маршрута; с индексом меток-хабов отвечает без поиска по графу
+    void BuildRouteTime(json::Builder& builder, int request_id, std::string_view from, std::string_view to);
+    
+    // Матрица времён в пути между остановками from и to, null — маршрута нет; with_items добавляет маршруты.
+    // Если какой-то остановки нет, возвращает ошибку
+    void BuildRouteMatrix(json::Builder& builder, int request_id, const json::Array& from, const json::Array& to,
+                          bool with_items);
+    
+    // Если остановки нет, возвращает ошибку
+    void BuildIsochrone(json::Builder& builder, int request_id, std::string_view stop_name, double max_time);
+    
+    // Счётчики кэша маршрутов; без кэша возвращает ошибку
+    void BuildRouteCacheStats(json::Builder& builder, int request_id);
+    
+    // Оперативные изменения маршрутизатора: close_stops и open_stops — закрыть и открыть остановки,
+    // bus_time_factors — множители времени в пути автобусов, disable_buses — выключить автобусы.
+    // Если какой-то остановки или автобуса нет или режим RAPTOR, ничего не меняет и возвращает ошибку
+    void BuildRouterUpdate(json::Builder& builder, const json::Dict& request);
+    
+    // Был ли маршрутизатор загружен из базы или построен при обработке запросов
+    void BuildRouterStatus(json::Builder& builder, int request_id);
     
     std::ostringstream PrintMap() const;
     
@@ -51,7 +96,9 @@ public:
     
     Buses GetBusesByStop(std::string_view stop) const;
     
-    std::optional<RouteItems> GetRouteByStops(std::string_view start_stop, std::string_view finish_stop) const;
+    // Маршрут в buffer.items, возвращает время в пути; std::nullopt — маршрута или какой-то из остановок нет
+    std::optional<double> GetRouteByStops(std::string_view start_stop, std::string_view finish_stop,
+                                          RouteBuffer& buffer, graph::SearchStats* stats = nullptr) const;
     
 private:
     const TransportCatalogue& db_;
@@ -60,6 +107,8 @@ private:
     MapRenderer& renderer_;
     TransportRouter& router_;
     Serializer& serializer_;
+    // Буфер маршрутов, общий для запросов Route
+    RouteBuffer route_buffer_;
     
 };
     
@@ -0,0 +1,116 @@
+#include "route_cache.h"
+
+namespace catalogue {
+
+RouteCache::RouteCache(size_t capacity_bytes, size_t shard_count)
+    : shard_capacity_bytes_(capacity_bytes / std::max<size_t>(shard_count, 1))
+    , shards_(std::max<size_t>(shard_count, 1)) {}
+
+RouteCache::Shard& RouteCache::GetShard(Key key) {
+    // Ключ перемешивается умножением: std::hash целых чисел его не меняет, а номера остановок идут подряд
+    return shards_[((key * 0x9E3779B97F4A7C15ull) >> 32) % shards_.size()];
+}
+
+size_t RouteCache::EstimateSize(const Value& value) {
+    // Запись списка, узел хеш-таблицы и её корзина
+    size_t size_bytes = sizeof(Entry) + 2 * sizeof(void*)
+                      + sizeof(std::pair<const Key, std::list<Entry>::iterator>) + 2 * sizeof(void*);
+    if (value) {
+        size_bytes += value->items.capacity() * sizeof(Item);
+    }
+    return size_bytes;
+}
+
+const RouteCache::Value* RouteCache::Touch(Shard& shard, Key key) {
+    const auto it = shard.index.find(key);
+    if (it == shard.index.end()) {
+        ++misses_;
+        return nullptr;
+    }
+    ++hits_;
+    shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+    return &it->second->value;
+}
+
+std::optional<RouteCache::Value> RouteCache::Get(Key key) {
+    Shard& shard = GetShard(key);
+    std::lock_guard lock(shard.mutex);
+    if (const Value* value = Touch(shard, key)) {
+        return *value;
+    }
+    return std::nullopt;
+}
+
+std::optional<std::optional<double>> RouteCache::Get(Key key, std::vector<Item>& items) {
+    items.clear();
+    Shard& shard = GetShard(key);
+    std::lock_guard lock(shard.mutex);
+    const Value* value = Touch(shard, key);
+    if (value == nullptr) {
+        return std::nullopt;
+    }
+    if (!*value) {
+        return std::make_optional(std::optional<double>{});
+    }
+    items.insert(items.end(), (*value)->items.begin(), (*value)->items.end());
+    return std::make_optional(std::optional<double>{(*value)->total_time});
+}
+
+void RouteCache::Put(Key key, Value value) {
+    const size_t size_bytes = EstimateSize(value);
+    if (size_bytes > shard_capacity_bytes_) {
+        return;
+    }
+    Shard& shard = GetShard(key);
+    std::lock_guard lock(shard.mutex);
+    if (const auto it = shard.index.find(key); it != shard.index.end()) {
+        shard.size_bytes -= it->second->size_bytes;
+        shard.entries.erase(it->second);
+        shard.index.erase(it);
+    }
+    while (shard.size_bytes + size_bytes > shard_capacity_bytes_) {
+        const Entry& oldest = shard.entries.back();
+        shard.size_bytes -= oldest.size_bytes;
+        shard.index.erase(oldest.key);
+        shard.entries.pop_back();
+        ++evictions_;
+    }
+    shard.entries.push_front({key, std::move(value), size_bytes});
+    shard.index[key] = shard.entries.begin();
+    shard.size_bytes += size_bytes;
+}
+
+void RouteCache::Clear() {
+    for (Shard& shard : shards_) {
+        std::lock_guard lock(shard.mutex);
+        shard.entries.clear();
+        shard.index.clear();
+        shard.size_bytes = 0;
+    }
+}
+
+void RouteCache::EraseIf(const std::function<bool(Key, const Value&)>& predicate) {
+    for (Shard& shard : shards_) {
+        std::lock_guard lock(shard.mutex);
+        for (auto it = shard.entries.begin(); it != shard.entries.end();) {
+            if (predicate(it->key, it->value)) {
+                shard.size_bytes -= it->size_bytes;
+                shard.index.erase(it->key);
+                it = shard.entries.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+}
+
+RouteCacheStats RouteCache::GetStats() const {
+    size_t size_bytes = 0;
+    for (const Shard& shard : shards_) {
+        std::lock_guard lock(shard.mutex);
+        size_bytes += shard.size_bytes;
+    }
+    return {hits_, misses_, evictions_, size_bytes};
+}
+
+} // namespace catalogue
@@ -0,0 +1,81 @@
+#pragma once
+#include "transport_router.h"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+namespace catalogue {
+
+// Потокобезопасный кэш готовых маршрутов между парами остановок с вытеснением
+// давно не использованных записей (LRU). Записи распределены по сегментам
+// с отдельными мьютексами; ёмкость задаётся в байтах и делится между сегментами поровну
+class RouteCache {
+public:
+    // Пара номеров остановок в одном числе: старшие 32 бита — откуда, младшие — куда
+    using Key = uint64_t;
+    // Отсутствующий маршрут тоже кэшируется
+    using Value = std::optional<RouteItems>;
+
+    explicit RouteCache(size_t capacity_bytes, size_t shard_count = 16);
+
+    static Key MakeKey(StopId from, StopId to) {
+        return static_cast<Key>(from) << 32 | to;
+    }
+
+    static StopId GetFrom(Key key) {
+        return static_cast<StopId>(key >> 32);
+    }
+
+    static StopId GetTo(Key key) {
+        return static_cast<StopId>(key);
+    }
+
+    // std::nullopt — в кэше нет записи для пары остановок
+    std::optional<Value> Get(Key key);
+
+    // То же, но элементы маршрута копируются в items без выделения памяти сверх их ёмкости,
+    // а возвращается время в пути; пустое время — в кэше записано отсутствие маршрута
+    std::optional<std::optional<double>> Get(Key key, std::vector<Item>& items);
+
+    void Put(Key key, Value value);
+
+    void Clear();
+
+    // Удаляет записи, для которых predicate(key, value) истинно
+    void EraseIf(const std::function<bool(Key, const Value&)>& predicate);
+
+    RouteCacheStats GetStats() const;
+
+private:
+    struct Entry {
+        Key key;
+        Value value;
+        size_t size_bytes;
+    };
+
+    struct Shard {
+        mutable std::mutex mutex;
+        std::list<Entry> entries; // от недавно использованных к давно не использованным
+        std::unordered_map<Key, std::list<Entry>::iterator> index;
+        size_t size_bytes = 0;
+    };
+
+    Shard& GetShard(Key key);
+
+    // Находит запись под мьютексом сегмента и переносит её в начало списка; nullptr — записи нет
+    const Value* Touch(Shard& shard, Key key);
+
+    static size_t EstimateSize(const Value& value);
+
+    size_t shard_capacity_bytes_;
+    std::vector<Shard> shards_;
+    std::atomic<size_t> hits_ = 0;
+    std::atomic<size_t> misses_ = 0;
+    std::atomic<size_t> evictions_ = 0;
+};
+
+} // namespace catalogue
@@ -1,117 +1,403 @@
 #pragma once
 
 #include "graph.h"
+#include "thread_pool.h"
 
 #include <algorithm>
 #include <cassert>
 #include <cstdint>
 #include <iterator>
+#include <limits>
 #include <optional>
 #include <stdexcept>
+#include <type_traits>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define TRANSPORT_CATALOGUE_ROUTER_AVX2
+#include <immintrin.h>
+#endif
+
 namespace graph {
 
-template <typename Weight>
-class Router {
-private:
-    using Graph = DirectedWeightedGraph<Weight>;
+// Статистика одного поиска маршрута
+struct SearchStats {
+    // Число вершин, извлечённых из очереди с окончательным весом
+    size_t settled_vertices = 0;
+};
 
+// Общий интерфейс движков маршрутизации по DirectedWeightedGraph
+template <typename Weight>
+class RoutingEngine {
 public:
-    explicit Router(const Graph& graph);
-
     struct RouteInfo {
         Weight weight;
         std::vector<EdgeId> edges;
     };
 
-    std::optional<RouteInfo> BuildRoute(VertexId from, VertexId to) const;
+    virtual ~RoutingEngine() = default;
+
+    virtual std::optional<RouteInfo> BuildRoute(VertexId from, VertexId to) const = 0;
+
+    // Строит маршрут и заполняет статистику поиска; табличные движки граф не обходят и оставляют её нулевой
+    virtual std::optional<RouteInfo> BuildRouteWithStats(VertexId from, VertexId to, SearchStats& stats) const {
+        stats = {};
+        return BuildRoute(from, to);
+    }
+
+    // Записывает рёбра маршрута в edges вместо нового вектора; ёмкость edges сохраняется, поэтому
+    // табличные движки с переиспользуемым буфером не выделяют память на запрос. Если передан stats,
+    // заполняет его, как BuildRouteWithStats. std::nullopt — маршрута нет
+    virtual std::optional<Weight> BuildRouteEdges(VertexId from, VertexId to, std::vector<EdgeId>& edges,
+                                                  SearchStats* stats) const {
+        edges.clear();
+        std::optional<RouteInfo> route = stats != nullptr ? BuildRouteWithStats(from, to, *stats) : BuildRoute(from, to);
+        if (!route) {
+            return std::nullopt;
+        }
+        edges.insert(edges.end(), route->edges.begin(), route->edges.end());
+        return route->weight;
+    }
+
+    // Маршруты из from в каждую из вершин targets; без with_edges у маршрутов заполняется только вес.
+    // По умолчанию — отдельный запрос на каждую пару, движки с поиском по графу обходят его один раз
+    virtual std::vector<std::optional<RouteInfo>> BuildRoutesFrom(VertexId from, const std::vector<VertexId>& targets,
+                                                                  bool with_edges) const {
+        std::vector<std::optional<RouteInfo>> routes;
+        routes.reserve(targets.size());
+        for (const VertexId to : targets) {
+            routes.push_back(BuildRoute(from, to));
+            if (routes.back() && !with_edges) {
+                routes.back()->edges.clear();
+            }
+        }
+        return routes;
+    }
+};
+
+// Таблица маршрутов между всеми парами вершин в двух непрерывных массивах,
+// ячейка (from, to) хранится по индексу from * vertex_count + to
+template <typename TableWeight>
+struct RoutesTable {
+    // Вес маршрута, UNREACHABLE — маршрута нет
+    std::vector<TableWeight> weights;
+    // Последнее ребро маршрута, NO_PREV_EDGE — маршрут пустой или его нет
+    std::vector<uint32_t> prev_edges;
+
+    static constexpr TableWeight UNREACHABLE = std::numeric_limits<TableWeight>::has_infinity
+                                             ? std::numeric_limits<TableWeight>::infinity()
+                                             : std::numeric_limits<TableWeight>::max();
+    static constexpr uint32_t NO_PREV_EDGE = std::numeric_limits<uint32_t>::max();
+};
+
+namespace detail {
+
+inline constexpr size_t ROUTES_BLOCK_SIZE = 64;
+
+// Min-plus обновление отрезка строки: weights[i] = min(weights[i], weight_from + through_weights[i]),
+// при улучшении prev_edges[i] берётся из through_prev_edges[i]
+template <typename TableWeight>
+void RelaxRoutesRowScalar(TableWeight weight_from, const TableWeight* through_weights,
+                          const uint32_t* through_prev_edges, TableWeight* weights, uint32_t* prev_edges,
+                          size_t count) {
+    constexpr TableWeight UNREACHABLE = RoutesTable<TableWeight>::UNREACHABLE;
+    for (size_t i = 0; i < count; ++i) {
+        if constexpr (!std::numeric_limits<TableWeight>::has_infinity) {
+            if (through_weights[i] == UNREACHABLE) {
+                continue;
+            }
+        }
+        const TableWeight candidate_weight = weight_from + through_weights[i];
+        if (candidate_weight < weights[i]) {
+            weights[i] = candidate_weight;
+            prev_edges[i] = through_prev_edges[i];
+        }
+    }
+}
+
+#ifdef TRANSPORT_CATALOGUE_ROUTER_AVX2
+// Та же операция на AVX2; недоступные ячейки хранят +inf, поэтому ветвления по ним не нужны.
+// Сложение и сравнение поэлементные, так что результат совпадает со скалярной версией бит в бит
+__attribute__((target("avx2")))
+inline void RelaxRoutesRowAvx2(double weight_from, const double* through_weights, const uint32_t* through_prev_edges,
+                               double* weights, uint32_t* prev_edges, size_t count) {
+    const __m256d weight_from_vector = _mm256_set1_pd(weight_from);
+    // Младшие 32 бита каждой 64-битной маски сравнения
+    const __m256i mask_lanes = _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m256d candidate = _mm256_add_pd(weight_from_vector, _mm256_loadu_pd(through_weights + i));
+        const __m256d current = _mm256_loadu_pd(weights + i);
+        const __m256d improved = _mm256_cmp_pd(candidate, current, _CMP_LT_OQ);
+        if (_mm256_movemask_pd(improved) == 0) {
+            continue;
+        }
+        _mm256_storeu_pd(weights + i, _mm256_blendv_pd(current, candidate, improved));
+        const __m128i edge_mask = _mm256_castsi256_si128(
+            _mm256_permutevar8x32_epi32(_mm256_castpd_si256(improved), mask_lanes));
+        _mm_maskstore_epi32(reinterpret_cast<int*>(prev_edges + i), edge_mask,
+                            _mm_loadu_si128(reinterpret_cast<const __m128i*>(through_prev_edges + i)));
+    }
+    RelaxRoutesRowScalar(weight_from, through_weights + i, through_prev_edges + i, weights + i, prev_edges + i,
+                         count - i);
+}
+
+__attribute__((target("avx2")))
+inline void RelaxRoutesRowAvx2(float weight_from, const float* through_weights, const uint32_t* through_prev_edges,
+                               float* weights, uint32_t* prev_edges, size_t count) {
+    const __m256 weight_from_vector = _mm256_set1_ps(weight_from);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m256 candidate = _mm256_add_ps(weight_from_vector, _mm256_loadu_ps(through_weights + i));
+        const __m256 current = _mm256_loadu_ps(weights + i);
+        const __m256 improved = _mm256_cmp_ps(candidate, current, _CMP_LT_OQ);
+        if (_mm256_movemask_ps(improved) == 0) {
+            continue;
+        }
+        _mm256_storeu_ps(weights + i, _mm256_blendv_ps(current, candidate, improved));
+        _mm256_maskstore_epi32(reinterpret_cast<int*>(prev_edges + i), _mm256_castps_si256(improved),
+                               _mm256_loadu_si256(reinterpret_cast<const __m256i*>(through_prev_edges + i)));
+    }
+    RelaxRoutesRowScalar(weight_from, through_weights + i, through_prev_edges + i, weights + i, prev_edges + i,
+                         count - i);
+}
+
+// Проверяется один раз за время работы программы
+inline bool HasAvx2() {
+    static const bool has_avx2 = __builtin_cpu_supports("avx2");
+    return has_avx2;
+}
+#endif
+
+template <typename TableWeight>
+void RelaxRoutesRow(TableWeight weight_from, const TableWeight* through_weights, const uint32_t* through_prev_edges,
+                    TableWeight* weights, uint32_t* prev_edges, size_t count) {
+#ifdef TRANSPORT_CATALOGUE_ROUTER_AVX2
+    if constexpr (std::is_same_v<TableWeight, double> || std::is_same_v<TableWeight, float>) {
+        if (HasAvx2()) {
+            RelaxRoutesRowAvx2(weight_from, through_weights, through_prev_edges, weights, prev_edges, count);
+            return;
+        }
+    }
+#endif
+    RelaxRoutesRowScalar(weight_from, through_weights, through_prev_edges, weights, prev_edges, count);
+}
+
+// Релаксирует маршруты из вершин from_block в вершины to_block через вершины through_block.
+// Новый маршрут from -> to заканчивается тем же ребром, что и маршрут through -> to:
+// при through == to он не может оказаться короче текущего
+template <typename TableWeight>
+void RelaxRoutesBlock(RoutesTable<TableWeight>& routes, size_t vertex_count,
+                      size_t through_block, size_t from_block, size_t to_block) {
+    constexpr TableWeight UNREACHABLE = RoutesTable<TableWeight>::UNREACHABLE;
+    const size_t through_end = std::min(vertex_count, (through_block + 1) * ROUTES_BLOCK_SIZE);
+    const size_t from_end = std::min(vertex_count, (from_block + 1) * ROUTES_BLOCK_SIZE);
+    const size_t to_begin = to_block * ROUTES_BLOCK_SIZE;
+    const size_t to_end = std::min(vertex_count, (to_block + 1) * ROUTES_BLOCK_SIZE);
+    TableWeight* weights = routes.weights.data();
+    uint32_t* prev_edges = routes.prev_edges.data();
+    for (size_t vertex_through = through_block * ROUTES_BLOCK_SIZE; vertex_through < through_end; ++vertex_through) {
+        const TableWeight* through_weights = weights + vertex_through * vertex_count;
+        const uint32_t* through_prev_edges = prev_edges + vertex_through * vertex_count;
+        for (size_t vertex_from = from_block * ROUTES_BLOCK_SIZE; vertex_from < from_end; ++vertex_from) {
+            TableWeight* from_weights = weights + vertex_from * vertex_count;
+            uint32_t* from_prev_edges = prev_edges + vertex_from * vertex_count;
+            const TableWeight weight_from = from_weights[vertex_through];
+            if (weight_from == UNREACHABLE) {
+                continue;
+            }
+            RelaxRoutesRow(weight_from, through_weights + to_begin, through_prev_edges + to_begin,
+                           from_weights + to_begin, from_prev_edges + to_begin, to_end - to_begin);
+        }
+    }
+}
+
+// Блочный алгоритм Флойда — Уоршелла по заполненной прямыми рёбрами таблице
+template <typename TableWeight>
+void RelaxRoutesTable(RoutesTable<TableWeight>& routes, size_t vertex_count, size_t thread_count) {
+    const size_t block_count = (vertex_count + ROUTES_BLOCK_SIZE - 1) / ROUTES_BLOCK_SIZE;
+    parallel::ThreadPool pool(std::min(thread_count, block_count));
+    for (size_t through_block = 0; through_block < block_count; ++through_block) {
+        RelaxRoutesBlock(routes, vertex_count, through_block, through_block, through_block);
+        pool.ParallelFor(block_count, [&routes, vertex_count, through_block](size_t block) {
+            if (block != through_block) {
+                RelaxRoutesBlock(routes, vertex_count, through_block, through_block, block);
+                RelaxRoutesBlock(routes, vertex_count, through_block, block, through_block);
+            }
+        });
+        pool.ParallelFor(block_count, [&routes, vertex_count, through_block, block_count](size_t from_block) {
+            if (from_block == through_block) { return; }
+            for (size_t to_block = 0; to_block < block_count; ++to_block) {
+                if (to_block != through_block) {
+                    RelaxRoutesBlock(routes, vertex_count, through_block, from_block, to_block);
+                }
+            }
+        });
+    }
+}
+
+} // namespace detail
 
+// Предвычисляет кратчайшие пути между всеми парами вершин блочным алгоритмом
+// Флойда — Уоршелла: на каждом шаге сначала обрабатывается диагональный блок,
+// затем параллельно блоки его строки и столбца, затем параллельно все остальные.
+// TableWeight задаёт тип весов в таблице: float вдвое сокращает её размер ценой точности
+template <typename Weight, typename TableWeight = Weight>
+class Router : public RoutingEngine<Weight> {
 private:
-    struct RouteInternalData {
-        Weight weight;
-        std::optional<EdgeId> prev_edge;
-    };
-    using RoutesInternalData = std::vector<std::vector<std::optional<RouteInternalData>>>;
+    using Graph = DirectedWeightedGraph<Weight>;
+
+public:
+    using RouteInfo = typename RoutingEngine<Weight>::RouteInfo;
+    using RoutesInternalData = RoutesTable<TableWeight>;
+
+    explicit Router(const Graph& graph, size_t thread_count = 1);
+
+    // Восстанавливает маршрутизатор по ранее вычисленной таблице без повторного расчёта
+    Router(const Graph& graph, RoutesInternalData routes_internal_data);
+
+    std::optional<RouteInfo> BuildRoute(VertexId from, VertexId to) const override;
+
+    std::optional<Weight> BuildRouteEdges(VertexId from, VertexId to, std::vector<EdgeId>& edges,
+                                          SearchStats* stats) const override;
+
+    // Без with_edges вес читается из таблицы, а рёбра маршрута не восстанавливаются; при весах таблицы
+    // пониженной точности вес по-прежнему пересчитывается по рёбрам
+    std::vector<std::optional<RouteInfo>> BuildRoutesFrom(VertexId from, const std::vector<VertexId>& targets,
+                                                          bool with_edges) const override;
+
+    const RoutesInternalData& GetRoutesInternalData() const;
+
+private:
+    static constexpr TableWeight UNREACHABLE = RoutesInternalData::UNREACHABLE;
+    static constexpr uint32_t NO_PREV_EDGE = RoutesInternalData::NO_PREV_EDGE;
 
     void InitializeRoutesInternalData(const Graph& graph) {
         const size_t vertex_count = graph.GetVertexCount();
+        if (graph.GetEdgeCount() >= NO_PREV_EDGE) {
+            throw std::length_error("Too many edges for 32-bit edge ids");
+        }
         for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
-            routes_internal_data_[vertex][vertex] = RouteInternalData{ZERO_WEIGHT, std::nullopt};
+            routes_internal_data_.weights[vertex * vertex_count + vertex] = ZERO_WEIGHT;
             for (const EdgeId edge_id : graph.GetIncidentEdges(vertex)) {
                 const auto& edge = graph.GetEdge(edge_id);
-                if (edge.weight < ZERO_WEIGHT) {
+                if (edge.weight < Weight{}) {
                     throw std::domain_error("Edges' weights should be non-negative");
                 }
-                auto& route_internal_data = routes_internal_data_[vertex][edge.to];
-                if (!route_internal_data || route_internal_data->weight > edge.weight) {
-                    route_internal_data = RouteInternalData{edge.weight, edge_id};
-                }
-            }
-        }
-    }
-
-    void RelaxRoute(VertexId vertex_from, VertexId vertex_to, const RouteInternalData& route_from,
-                    const RouteInternalData& route_to) {
-        auto& route_relaxing = routes_internal_data_[vertex_from][vertex_to];
-        const Weight candidate_weight = route_from.weight + route_to.weight;
-        if (!route_relaxing || candidate_weight < route_relaxing->weight) {
-            route_relaxing = {candidate_weight,
-                              route_to.prev_edge ? route_to.prev_edge : route_from.prev_edge};
-        }
-    }
-
-    void RelaxRoutesInternalDataThroughVertex(size_t vertex_count, VertexId vertex_through) {
-        for (VertexId vertex_from = 0; vertex_from < vertex_count; ++vertex_from) {
-            if (const auto& route_from = routes_internal_data_[vertex_from][vertex_through]) {
-                for (VertexId vertex_to = 0; vertex_to < vertex_count; ++vertex_to) {
-                    if (const auto& route_to = routes_internal_data_[vertex_through][vertex_to]) {
-                        RelaxRoute(vertex_from, vertex_to, *route_from, *route_to);
-                    }
+                const size_t index = vertex * vertex_count + edge.to;
+                const TableWeight weight = static_cast<TableWeight>(edge.weight);
+                if (routes_internal_data_.weights[index] > weight) {
+                    routes_internal_data_.weights[index] = weight;
+                    routes_internal_data_.prev_edges[index] = static_cast<uint32_t>(edge_id);
                 }
             }
         }
     }
 
-    static constexpr Weight ZERO_WEIGHT{};
+    static constexpr TableWeight ZERO_WEIGHT{};
     const Graph& graph_;
     RoutesInternalData routes_internal_data_;
 };
 
-template <typename Weight>
-Router<Weight>::Router(const Graph& graph)
+template <typename Weight, typename TableWeight>
+Router<Weight, TableWeight>::Router(const Graph& graph, size_t thread_count)
     : graph_(graph)
-    , routes_internal_data_(graph.GetVertexCount(),
-                            std::vector<std::optional<RouteInternalData>>(graph.GetVertexCount()))
 {
+    const size_t vertex_count = graph.GetVertexCount();
+    routes_internal_data_.weights.assign(vertex_count * vertex_count, UNREACHABLE);
+    routes_internal_data_.prev_edges.assign(vertex_count * vertex_count, NO_PREV_EDGE);
     InitializeRoutesInternalData(graph);
+    detail::RelaxRoutesTable(routes_internal_data_, vertex_count, std::max<size_t>(thread_count, 1));
+}
 
-    const size_t vertex_count = graph.GetVertexCount();
-    for (VertexId vertex_through = 0; vertex_through < vertex_count; ++vertex_through) {
-        RelaxRoutesInternalDataThroughVertex(vertex_count, vertex_through);
+template <typename Weight, typename TableWeight>
+Router<Weight, TableWeight>::Router(const Graph& graph, RoutesInternalData routes_internal_data)
+    : graph_(graph)
+    , routes_internal_data_(std::move(routes_internal_data))
+{
+    const size_t cell_count = graph.GetVertexCount() * graph.GetVertexCount();
+    if (routes_internal_data_.weights.size() != cell_count || routes_internal_data_.prev_edges.size() != cell_count) {
+        throw std::invalid_argument("Routes internal data doesn't match the graph");
     }
 }
 
-template <typename Weight>
-std::optional<typename Router<Weight>::RouteInfo> Router<Weight>::BuildRoute(VertexId from,
-                                                                             VertexId to) const {
-    const auto& route_internal_data = routes_internal_data_.at(from).at(to);
-    if (!route_internal_data) {
+template <typename Weight, typename TableWeight>
+const typename Router<Weight, TableWeight>::RoutesInternalData& Router<Weight, TableWeight>::GetRoutesInternalData() const {
+    return routes_internal_data_;
+}
+
+template <typename Weight, typename TableWeight>
+std::optional<typename Router<Weight, TableWeight>::RouteInfo> Router<Weight, TableWeight>::BuildRoute(VertexId from,
+                                                                                                       VertexId to) const {
+    std::vector<EdgeId> edges;
+    const std::optional<Weight> weight = BuildRouteEdges(from, to, edges, nullptr);
+    if (!weight) {
         return std::nullopt;
     }
-    const Weight weight = route_internal_data->weight;
-    std::vector<EdgeId> edges;
-    for (std::optional<EdgeId> edge_id = route_internal_data->prev_edge;
-         edge_id;
-         edge_id = routes_internal_data_[from][graph_.GetEdge(*edge_id).from]->prev_edge)
+    return RouteInfo{*weight, std::move(edges)};
+}
+
+template <typename Weight, typename TableWeight>
+std::optional<Weight> Router<Weight, TableWeight>::BuildRouteEdges(VertexId from, VertexId to,
+                                                                   std::vector<EdgeId>& edges,
+                                                                   SearchStats* stats) const {
+    const size_t vertex_count = graph_.GetVertexCount();
+    if (from >= vertex_count || to >= vertex_count) {
+        throw std::out_of_range("Vertex id is out of range");
+    }
+    if (stats != nullptr) {
+        *stats = {};
+    }
+    const TableWeight* from_weights = routes_internal_data_.weights.data() + from * vertex_count;
+    const uint32_t* from_prev_edges = routes_internal_data_.prev_edges.data() + from * vertex_count;
+    edges.clear();
+    if (from_weights[to] == UNREACHABLE) {
+        return std::nullopt;
+    }
+    Weight weight = static_cast<Weight>(from_weights[to]);
+    for (uint32_t edge_id = from_prev_edges[to];
+         edge_id != NO_PREV_EDGE;
+         edge_id = from_prev_edges[graph_.GetEdge(edge_id).from])
     {
-        edges.push_back(*edge_id);
+        edges.push_back(edge_id);
     }
     std::reverse(edges.begin(), edges.end());
+    if constexpr (!std::is_same_v<Weight, TableWeight>) {
+        // Таблица хранит веса с пониженной точностью, поэтому вес маршрута пересчитывается по рёбрам графа
+        weight = Weight{};
+        for (const EdgeId edge_id : edges) {
+            weight += graph_.GetEdge(edge_id).weight;
+        }
+    }
+    return weight;
+}
 
-    return RouteInfo{weight, std::move(edges)};
+template <typename Weight, typename TableWeight>
+std::vector<std::optional<typename Router<Weight, TableWeight>::RouteInfo>>
+Router<Weight, TableWeight>::BuildRoutesFrom(VertexId from, const std::vector<VertexId>& targets, bool with_edges) const {
+    if (with_edges || !std::is_same_v<Weight, TableWeight>) {
+        return RoutingEngine<Weight>::BuildRoutesFrom(from, targets, with_edges);
+    }
+    const size_t vertex_count = graph_.GetVertexCount();
+    if (from >= vertex_count) {
+        throw std::out_of_range("Vertex id is out of range");
+    }
+    const TableWeight* from_weights = routes_internal_data_.weights.data() + from * vertex_count;
+    std::vector<std::optional<RouteInfo>> routes;
+    routes.reserve(targets.size());
+    for (const VertexId to : targets) {
+        if (to >= vertex_count) {
+            throw std::out_of_range("Vertex id is out of range");
+        }
+        if (from_weights[to] == UNREACHABLE) {
+            routes.push_back(std::nullopt);
+        } else {
+            routes.push_back(RouteInfo{static_cast<Weight>(from_weights[to]), {}});
+        }
+    }
+    return routes;
 }
 
 }  // namespace graph
\ No newline at end of file
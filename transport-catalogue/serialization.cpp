@@ -1,7 +1,12 @@
 #include "serialization.h"
 #include "transport_catalogue.pb.h"
 
+#include <algorithm>
 #include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
 
 namespace catalogue {
 
@@ -14,26 +19,36 @@ void Serializer::SetSettings(std::string filename) {
 
 tcat_serialized::Stop SerializeStop(const Stop* stop_ptr) {
     tcat_serialized::Stop stop;
-    stop.set_name(stop_ptr->name);
+    stop.set_name(stop_ptr->name.data(), stop_ptr->name.size());
     stop.mutable_coordinates()->set_lng(stop_ptr->coordinates.lng);
     stop.mutable_coordinates()->set_lat(stop_ptr->coordinates.lat);
     return stop;
 }
 
-tcat_serialized::Bus SerializeBus(const Bus* bus_ptr) {
+tcat_serialized::BusStat SerializeBusStat(const BusStat& bus_stat) {
+    tcat_serialized::BusStat stat;
+    stat.set_stop_count(bus_stat.stops_count);
+    stat.set_unique_stop_count(bus_stat.unique_stops_count);
+    stat.set_route_length(bus_stat.route_length);
+    stat.set_real_route_length(bus_stat.real_route_length);
+    return stat;
+}
+
+tcat_serialized::Bus SerializeBus(const Bus* bus_ptr, const BusStat& bus_stat) {
     tcat_serialized::Bus bus;
-    bus.set_name(bus_ptr->name);
+    bus.set_name(bus_ptr->name.data(), bus_ptr->name.size());
     bus.set_is_roundtrip(bus_ptr->is_roundtrip);
-    for (const Stop* stop_ptr : bus_ptr->stops) {
-        bus.add_stops(reinterpret_cast<uint64_t>(stop_ptr));
+    for (const StopId stop : bus_ptr->stops) {
+        bus.add_stops(stop);
     }
+    *bus.mutable_stat() = SerializeBusStat(bus_stat);
     return bus;
 }
 
-tcat_serialized::Distance SerializeDistance(const Stop* src, const Stop* dst, int64_t distance) {
+tcat_serialized::Distance SerializeDistance(StopId src, StopId dst, int64_t distance) {
     tcat_serialized::Distance stop_dist;
-    stop_dist.set_src(reinterpret_cast<uint64_t>(src));
-    stop_dist.set_dst(reinterpret_cast<uint64_t>(dst));
+    stop_dist.set_src(src);
+    stop_dist.set_dst(dst);
     stop_dist.set_distance(distance);
     return stop_dist;
 }
@@ -80,30 +95,148 @@ tcat_serialized::RenderSettings SerializeRenderSettings(renderer::RenderSettings
     return render_settings;
 }
 
+tcat_serialized::RouterMode SerializeRouterMode(RouterMode mode) {
+    switch (mode) {
+        case RouterMode::DIJKSTRA:
+            return tcat_serialized::ROUTER_MODE_DIJKSTRA;
+        case RouterMode::STOP_PAIRS:
+            return tcat_serialized::ROUTER_MODE_STOP_PAIRS;
+        case RouterMode::CONTRACTION_HIERARCHIES:
+            return tcat_serialized::ROUTER_MODE_CONTRACTION_HIERARCHIES;
+        case RouterMode::A_STAR:
+            return tcat_serialized::ROUTER_MODE_A_STAR;
+        case RouterMode::RAPTOR:
+            return tcat_serialized::ROUTER_MODE_RAPTOR;
+        default:
+            return tcat_serialized::ROUTER_MODE_ALL_PAIRS;
+    }
+}
+
 tcat_serialized::RouterSettings SerializeRouterSettings(RouterSettings settings) {
     tcat_serialized::RouterSettings router_settings;
     router_settings.set_time(settings.time);
     router_settings.set_velocity(settings.velocity);
+    router_settings.set_mode(SerializeRouterMode(settings.mode));
+    router_settings.set_thread_count(settings.thread_count);
+    router_settings.set_compact_table(settings.compact_table);
+    router_settings.set_route_cache_size(settings.route_cache_size);
+    router_settings.set_hub_labels(settings.hub_labels);
+    for (const auto& [name, profile] : settings.profiles) {
+        tcat_serialized::RoutingProfile& profile_data = (*router_settings.mutable_profiles())[name];
+        profile_data.set_time(profile.time);
+        profile_data.set_velocity(profile.velocity);
+    }
     return router_settings;
 }
 
+tcat_serialized::Edge SerializeEdge(const graph::Edge<double>& route_edge, const Item& item) {
+    tcat_serialized::Edge edge;
+    edge.set_id(item.id);
+    edge.set_quality(item.span_count);
+    edge.set_from(static_cast<int32_t>(route_edge.from));
+    edge.set_to(static_cast<int32_t>(route_edge.to));
+    edge.set_weight(route_edge.weight);
+    edge.set_is_wait(item.type == ItemType::WAIT);
+    edge.set_distance(item.distance);
+    return edge;
+}
+
+template <typename TableWeight>
+tcat_serialized::RoutesInternalData SerializeRoutesTable(const graph::RoutesTable<TableWeight>& routes) {
+    tcat_serialized::RoutesInternalData routes_data;
+    for (const TableWeight weight : routes.weights) {
+        if constexpr (std::is_same_v<TableWeight, float>) {
+            routes_data.add_compact_weight(weight);
+        } else {
+            routes_data.add_weight(weight);
+        }
+    }
+    for (const uint32_t prev_edge : routes.prev_edges) {
+        routes_data.add_prev_edge(prev_edge != graph::RoutesTable<TableWeight>::NO_PREV_EDGE ? prev_edge + 1 : 0);
+    }
+    return routes_data;
+}
+
+tcat_serialized::ContractionHierarchy SerializeHierarchy(const graph::ContractionHierarchy<double>::HierarchyData& hierarchy) {
+    tcat_serialized::ContractionHierarchy hierarchy_data;
+    for (const uint32_t rank : hierarchy.ranks) {
+        hierarchy_data.add_rank(rank);
+    }
+    for (const auto& shortcut : hierarchy.shortcuts) {
+        tcat_serialized::Shortcut* shortcut_data = hierarchy_data.add_shortcut();
+        shortcut_data->set_from(shortcut.from);
+        shortcut_data->set_to(shortcut.to);
+        shortcut_data->set_weight(shortcut.weight);
+        shortcut_data->set_first(shortcut.first);
+        shortcut_data->set_second(shortcut.second);
+    }
+    return hierarchy_data;
+}
+
+tcat_serialized::Labels SerializeLabels(const graph::HubLabels<double>::Labels& labels) {
+    tcat_serialized::Labels labels_data;
+    *labels_data.mutable_offset() = {labels.offsets.begin(), labels.offsets.end()};
+    *labels_data.mutable_hub() = {labels.hubs.begin(), labels.hubs.end()};
+    *labels_data.mutable_weight() = {labels.weights.begin(), labels.weights.end()};
+    return labels_data;
+}
+
+tcat_serialized::TransportRouter SerializeTransportRouter(const TransportRouter& router) {
+    tcat_serialized::TransportRouter router_data;
+    const graph::DirectedWeightedGraph<double>& route_graph = router.GetGraph();
+    const std::vector<Item>& edge_items = router.GetEdgeItems();
+    router_data.mutable_graph()->set_vertex_count(route_graph.GetVertexCount());
+    for (graph::EdgeId edge_id = 0; edge_id < route_graph.GetEdgeCount(); ++edge_id) {
+        *router_data.mutable_graph()->add_edge() = SerializeEdge(route_graph.GetEdge(edge_id), edge_items[edge_id]);
+    }
+    const std::vector<std::pair<int, int>>& stop_to_vertexes = router.GetStopVertexes();
+    for (StopId stop = 0; stop < stop_to_vertexes.size(); ++stop) {
+        const auto& vertexes = stop_to_vertexes[stop];
+        tcat_serialized::StopVertexes* stop_vertexes = router_data.add_stop_vertexes();
+        stop_vertexes->set_stop_id(stop);
+        stop_vertexes->set_wait_vertex(vertexes.first);
+        stop_vertexes->set_bus_vertex(vertexes.second);
+    }
+    const graph::GraphComponents& components = router.GetComponents();
+    *router_data.mutable_components()->mutable_strong() = {components.strong.begin(), components.strong.end()};
+    *router_data.mutable_components()->mutable_weak() = {components.weak.begin(), components.weak.end()};
+    if (const graph::RoutesTable<double>* routes = router.GetRoutesTable<double>()) {
+        *router_data.mutable_routes() = SerializeRoutesTable(*routes);
+    } else if (const graph::RoutesTable<float>* compact_routes = router.GetRoutesTable<float>()) {
+        *router_data.mutable_routes() = SerializeRoutesTable(*compact_routes);
+    } else if (const auto* hierarchy = router.GetHierarchyData()) {
+        *router_data.mutable_hierarchy() = SerializeHierarchy(*hierarchy);
+    }
+    if (const auto* hub_labels = router.GetHubLabelsData()) {
+        *router_data.mutable_hub_labels()->mutable_forward() = SerializeLabels(hub_labels->forward);
+        *router_data.mutable_hub_labels()->mutable_backward() = SerializeLabels(hub_labels->backward);
+    }
+    return router_data;
+}
+
 Stop DeserializeStop(const tcat_serialized::Stop& stop) {
     return {stop.name(), {stop.coordinates().lat(), stop.coordinates().lng()}};
 }
 
-Bus DeserializeBus(const TransportCatalogue& db, tcat_serialized::TransportCatalogue& tcat, const tcat_serialized::Bus& bus) {
-    Bus bus_result;
-    bus_result.name = bus.name();
-    bus_result.is_roundtrip = bus.is_roundtrip();
+// Номера остановок в базе совпадают с их номерами в загруженном каталоге
+StopId DeserializeStopId(const TransportCatalogue& db, uint64_t stop_id) {
+    if (stop_id >= db.GetStopsCount()) {
+        throw std::invalid_argument("Serialized base refers to an unknown stop id: " + std::to_string(stop_id));
+    }
+    return static_cast<StopId>(stop_id);
+}
+
+void DeserializeBus(TransportCatalogue& db, const tcat_serialized::Bus& bus) {
+    std::vector<StopId> stops;
+    stops.reserve(bus.stops_size());
     for (const auto stops_id : bus.stops()) {
-        bus_result.stops.push_back(db.GetStop((*tcat.mutable_stops())[stops_id].name()));
+        stops.push_back(DeserializeStopId(db, stops_id));
     }
-    return bus_result;
-    
+    db.AddBus(bus.name(), stops, bus.is_roundtrip());
 }
 
-const Stop* GetStopPtr(const TransportCatalogue& db, tcat_serialized::TransportCatalogue& tcat, uint64_t stops_id) {
-    return db.GetStop((*tcat.mutable_stops())[stops_id].name());
+BusStat DeserializeBusStat(const tcat_serialized::BusStat& stat) {
+    return {stat.stop_count(), stat.unique_stop_count(), stat.route_length(), stat.real_route_length()};
 }
 
 svg::Color DeserializeColor(tcat_serialized::Color color) {
@@ -149,53 +282,229 @@ renderer::RenderSettings DeserializeRenderSettings(const tcat_serialized::Render
     return render_settings;
 }
     
+Item DeserializeItem(const TransportCatalogue& db, const tcat_serialized::Edge& edge) {
+    Item item;
+    if (edge.is_wait()) {
+        item.type = ItemType::WAIT;
+        item.name = db.GetStopById(DeserializeStopId(db, edge.id()))->name;
+    } else {
+        item.type = ItemType::BUS;
+        if (edge.id() >= db.GetBusesCount()) {
+            throw std::invalid_argument("Serialized graph refers to an unknown bus id: " + std::to_string(edge.id()));
+        }
+        item.name = db.GetBusById(edge.id())->name;
+    }
+    item.id = edge.id();
+    item.time = edge.weight();
+    item.span_count = edge.quality();
+    item.distance = edge.distance();
+    return item;
+}
+
+template <typename TableWeight, typename SerializedWeights>
+graph::RoutesTable<TableWeight> DeserializeRoutesTable(const SerializedWeights& weights,
+                                                       const tcat_serialized::RoutesInternalData& routes_data) {
+    if (routes_data.prev_edge_size() != weights.size()) {
+        throw std::invalid_argument("Serialized routes don't match the graph");
+    }
+    graph::RoutesTable<TableWeight> routes;
+    routes.weights.assign(weights.begin(), weights.end());
+    routes.prev_edges.reserve(routes_data.prev_edge_size());
+    for (const uint64_t prev_edge : routes_data.prev_edge()) {
+        routes.prev_edges.push_back(prev_edge != 0 ? static_cast<uint32_t>(prev_edge - 1)
+                                                   : graph::RoutesTable<TableWeight>::NO_PREV_EDGE);
+    }
+    return routes;
+}
+
+graph::ContractionHierarchy<double>::HierarchyData DeserializeHierarchy(const tcat_serialized::ContractionHierarchy& hierarchy_data) {
+    graph::ContractionHierarchy<double>::HierarchyData hierarchy;
+    hierarchy.ranks.assign(hierarchy_data.rank().begin(), hierarchy_data.rank().end());
+    hierarchy.shortcuts.reserve(hierarchy_data.shortcut_size());
+    for (const auto& shortcut : hierarchy_data.shortcut()) {
+        hierarchy.shortcuts.push_back({static_cast<graph::VertexId>(shortcut.from()),
+                                       static_cast<graph::VertexId>(shortcut.to()),
+                                       shortcut.weight(),
+                                       static_cast<graph::EdgeId>(shortcut.first()),
+                                       static_cast<graph::EdgeId>(shortcut.second())});
+    }
+    return hierarchy;
+}
+
+graph::HubLabels<double>::Labels DeserializeLabels(const tcat_serialized::Labels& labels_data) {
+    graph::HubLabels<double>::Labels labels;
+    labels.offsets.assign(labels_data.offset().begin(), labels_data.offset().end());
+    labels.hubs.assign(labels_data.hub().begin(), labels_data.hub().end());
+    labels.weights.assign(labels_data.weight().begin(), labels_data.weight().end());
+    return labels;
+}
+
+void DeserializeTransportRouter(const TransportCatalogue& db, const tcat_serialized::TransportRouter& router_data,
+                                TransportRouter& router) {
+    const size_t vertex_count = router_data.graph().vertex_count();
+    graph::DirectedWeightedGraph<double> route_graph(vertex_count);
+    std::vector<Item> edge_items;
+    edge_items.reserve(router_data.graph().edge_size());
+    for (const auto& edge : router_data.graph().edge()) {
+        route_graph.AddEdge({static_cast<graph::VertexId>(edge.from()),
+                             static_cast<graph::VertexId>(edge.to()),
+                             edge.weight()});
+        edge_items.push_back(DeserializeItem(db, edge));
+    }
+    std::vector<std::pair<int, int>> stop_to_vertexes(db.GetStopsCount());
+    for (const auto& stop_vertexes : router_data.stop_vertexes()) {
+        stop_to_vertexes[DeserializeStopId(db, stop_vertexes.stop_id())] = {stop_vertexes.wait_vertex(),
+                                                                  stop_vertexes.bus_vertex()};
+    }
+    std::optional<graph::GraphComponents> components;
+    if (router_data.has_components()) {
+        components = graph::GraphComponents{{router_data.components().strong().begin(), router_data.components().strong().end()},
+                                            {router_data.components().weak().begin(), router_data.components().weak().end()}};
+    }
+    router.RestoreGraph(std::move(route_graph), std::move(edge_items), std::move(stop_to_vertexes),
+                        std::move(components));
+    
+    const tcat_serialized::RoutesInternalData& routes_data = router_data.routes();
+    if (routes_data.weight_size() != 0) {
+        router.RestoreRouter(DeserializeRoutesTable<double>(routes_data.weight(), routes_data));
+    } else if (routes_data.compact_weight_size() != 0) {
+        router.RestoreRouter(DeserializeRoutesTable<float>(routes_data.compact_weight(), routes_data));
+    } else if (router_data.has_hierarchy()) {
+        router.RestoreHierarchy(DeserializeHierarchy(router_data.hierarchy()));
+    } else {
+        router.BuildRouter();
+    }
+    if (router_data.has_hub_labels()) {
+        router.RestoreHubLabels({DeserializeLabels(router_data.hub_labels().forward()),
+                                 DeserializeLabels(router_data.hub_labels().backward())});
+    } else {
+        router.BuildHubLabels();
+    }
+}
+    
+RouterMode DeserializeRouterMode(tcat_serialized::RouterMode mode) {
+    switch (mode) {
+        case tcat_serialized::ROUTER_MODE_DIJKSTRA:
+            return RouterMode::DIJKSTRA;
+        case tcat_serialized::ROUTER_MODE_STOP_PAIRS:
+            return RouterMode::STOP_PAIRS;
+        case tcat_serialized::ROUTER_MODE_CONTRACTION_HIERARCHIES:
+            return RouterMode::CONTRACTION_HIERARCHIES;
+        case tcat_serialized::ROUTER_MODE_A_STAR:
+            return RouterMode::A_STAR;
+        case tcat_serialized::ROUTER_MODE_RAPTOR:
+            return RouterMode::RAPTOR;
+        default:
+            return RouterMode::ALL_PAIRS;
+    }
+}
+    
 RouterSettings DeserializeRouterSettings(const tcat_serialized::RouterSettings& settings) {
-    return {settings.time(), settings.velocity()};
+    std::map<std::string, RoutingProfile, std::less<>> profiles;
+    for (const auto& [name, profile] : settings.profiles()) {
+        profiles[name] = {profile.time(), profile.velocity()};
+    }
+    return {settings.time(),
+            settings.velocity(),
+            DeserializeRouterMode(settings.mode()),
+            settings.thread_count(),
+            settings.compact_table(),
+            settings.route_cache_size(),
+            std::move(profiles),
+            settings.hub_labels()};
 }
     
 void Serializer::SerializeBase() {
     std::ofstream output(filename_, std::ios::binary);
     
     tcat_serialized::TransportCatalogue catalogue;
-    for (const auto& [name, stop_ptr] : db_.GetAllStops()) {
-        (*catalogue.mutable_stops())[reinterpret_cast<uint64_t>(stop_ptr)] = SerializeStop(stop_ptr);
+    for (StopId stop = 0; stop < db_.GetStopsCount(); ++stop) {
+        (*catalogue.mutable_stops())[stop] = SerializeStop(db_.GetStopById(stop));
     }
     
-    for (const auto& [name, bus_ptr] : db_.GetAllBuses()) {
-        *catalogue.add_buses() = SerializeBus(bus_ptr);
+    // По возрастанию номеров: при загрузке автобусы получат те же номера, на которые ссылаются рёбра графа
+    for (BusId bus = 0; bus < db_.GetBusesCount(); ++bus) {
+        const Bus* bus_ptr = db_.GetBusById(bus);
+        *catalogue.add_buses() = SerializeBus(bus_ptr, db_.GetBusStat(bus_ptr));
     }
     
-    for (const auto& [stop_ptrs, distance] : db_.GetAllDistances()) {
-        *catalogue.add_distances() = SerializeDistance(stop_ptrs.first, stop_ptrs.second, distance);
-    }
+    db_.GetAllDistances().ForEach([&catalogue](StopId src, StopId dst, int64_t distance) {
+        *catalogue.add_distances() = SerializeDistance(src, dst, distance);
+    });
     
     *catalogue.mutable_render_settings() = SerializeRenderSettings(renderer_.GetSettings());
     *catalogue.mutable_router_settings() = SerializeRouterSettings(router_.GetSettings());
+    // Без графа (режим RAPTOR) маршрутизатор восстанавливается по каталогу
+    if (router_.HasGraph()) {
+        *catalogue.mutable_router() = SerializeTransportRouter(router_);
+    }
     
     catalogue.SerializeToOstream(&output);
 }
 
 void Serializer::DeserializeBase() {
     std::ifstream input(filename_, std::ios::binary);
-    tcat_serialized::TransportCatalogue serialized_catalogue;
+    tcat_serialized::TransportCatalogueHeader serialized_catalogue;
     
     serialized_catalogue.ParseFromIstream(&input);
     
-    for (const auto& [stop_ptr, stop] : serialized_catalogue.stops()) {
-        db_.AddStop(DeserializeStop(stop));
+    // Ключи остановок в базе — их номера 0, 1, ..., поэтому остановки добавляются по номерам
+    // и в загруженном каталоге получают те же номера
+    const auto& stops = serialized_catalogue.stops();
+    db_.ReserveStops(stops.size());
+    for (size_t stop = 0; stop < stops.size(); ++stop) {
+        const auto it = stops.find(stop);
+        if (it == stops.end()) {
+            throw std::invalid_argument("Serialized stop ids should be dense");
+        }
+        db_.AddStop(DeserializeStop(it->second));
     }
     
+    std::vector<BusStat> bus_stats;
+    bus_stats.reserve(serialized_catalogue.buses_size());
     for (const auto& bus : serialized_catalogue.buses()) {
-        db_.AddBus(DeserializeBus(db_, serialized_catalogue, bus));
+        DeserializeBus(db_, bus);
+        if (bus.has_stat()) {
+            bus_stats.push_back(DeserializeBusStat(bus.stat()));
+        }
     }
     
     for (const auto& dist : serialized_catalogue.distances()) {
-        db_.SetDistance(GetStopPtr(db_, serialized_catalogue, dist.src()),
-                                    GetStopPtr(db_, serialized_catalogue, dist.dst()),
-                                    dist.distance());
+        db_.SetDistance(db_.GetStopById(DeserializeStopId(db_, dist.src())),
+                        db_.GetStopById(DeserializeStopId(db_, dist.dst())), dist.distance());
     }
     
     renderer_.SetSettings(DeserializeRenderSettings(serialized_catalogue.render_settings()));
     router_.SetSettings(DeserializeRouterSettings(serialized_catalogue.router_settings()));
+    // В базах без статистики автобусов она считается при загрузке
+    if (bus_stats.size() == static_cast<size_t>(serialized_catalogue.buses_size())) {
+        db_.SetBusStats(std::move(bus_stats));
+    } else {
+        db_.ComputeBusStats(router_.GetSettings().thread_count);
+    }
+    router_data_ = std::move(*serialized_catalogue.mutable_router());
+    router_deserialized_ = false;
+}
+
+void Serializer::DeserializeRouter() {
+    if (router_deserialized_) {
+        return;
+    }
+    if (!router_data_.empty()) {
+        tcat_serialized::TransportRouter router_data;
+        if (!router_data.ParseFromString(router_data_)) {
+            throw std::runtime_error("Failed to parse serialized router");
+        }
+        DeserializeTransportRouter(db_, router_data, router_);
+    } else {
+        router_.BuildAllRoutes();
+    }
+    router_data_.clear();
+    router_data_.shrink_to_fit();
+    router_deserialized_ = true;
+}
+
+bool Serializer::IsRouterDeserialized() const {
+    return router_deserialized_;
 }
 } // namespace catalogue
\ No newline at end of file
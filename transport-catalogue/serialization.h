@@ -3,6 +3,8 @@
 #include "map_renderer.h"
 #include "transport_router.h"
 
+#include <string>
+
 namespace catalogue {
 class Serializer {
 public:
@@ -10,8 +12,15 @@ public:
     
     void SerializeBase();
     
+    // Загружает каталог и настройки; раздел маршрутизатора только сохраняется в исходном виде
     void DeserializeBase();
     
+    // Восстанавливает маршрутизатор из сохранённого раздела базы, а если его нет — строит заново.
+    // Повторные вызовы ничего не делают
+    void DeserializeRouter();
+    
+    bool IsRouterDeserialized() const;
+    
     void SetSettings(std::string filename);
     
 private:
@@ -19,5 +28,8 @@ private:
     renderer::MapRenderer& renderer_;
     TransportRouter& router_;
     std::string filename_;
+    // Неразобранный раздел маршрутизатора из базы
+    std::string router_data_;
+    bool router_deserialized_ = false;
 };
 } // namespace catalogue
\ No newline at end of file
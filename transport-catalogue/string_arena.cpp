@@ -0,0 +1,28 @@
+#include "string_arena.h"
+
+#include <algorithm>
+
+namespace catalogue {
+
+std::string_view StringArena::Store(std::string_view str) {
+    if (str.empty()) {
+        return {};
+    }
+    char* data = nullptr;
+    if (str.size() > BLOCK_SIZE) {
+        auto block = std::make_unique<char[]>(str.size());
+        data = block.get();
+        blocks_.insert(blocks_.empty() ? blocks_.end() : blocks_.end() - 1, std::move(block));
+    } else {
+        if (block_used_ + str.size() > BLOCK_SIZE) {
+            blocks_.push_back(std::make_unique<char[]>(BLOCK_SIZE));
+            block_used_ = 0;
+        }
+        data = blocks_.back().get() + block_used_;
+        block_used_ += str.size();
+    }
+    std::copy(str.begin(), str.end(), data);
+    return {data, str.size()};
+}
+
+} // namespace catalogue
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace catalogue {
+
+// Хранилище строк крупными блоками вместо отдельного выделения памяти на каждую строку.
+// Сохранённые строки не перемещаются, пока жива арена, поэтому на них можно ссылаться через std::string_view
+class StringArena {
+public:
+    // Копирует строку в арену и возвращает ссылку на копию
+    std::string_view Store(std::string_view str);
+
+private:
+    static constexpr size_t BLOCK_SIZE = 64 * 1024;
+
+    std::vector<std::unique_ptr<char[]>> blocks_;
+    // Занятая часть последнего блока; строки длиннее блока получают отдельный блок перед ним
+    size_t block_used_ = BLOCK_SIZE;
+};
+
+} // namespace catalogue
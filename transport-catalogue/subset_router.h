@@ -0,0 +1,186 @@
+#pragma once
+
+#include "router.h"
+
+namespace graph {
+
+// Предвычисляет кратчайшие пути только между парами выделенных вершин.
+// Остальные вершины проходятся транзитом: у каждой из них должно быть не больше
+// одного входящего ребра, тогда участок пути через них однозначно восстанавливается
+// по последнему ребру. Таблица строится алгоритмом Флойда — Уоршелла по графу
+// из составных рёбер между выделенными вершинами
+template <typename Weight, typename TableWeight = Weight>
+class SubsetRouter : public RoutingEngine<Weight> {
+private:
+    using Graph = DirectedWeightedGraph<Weight>;
+
+public:
+    using RouteInfo = typename RoutingEngine<Weight>::RouteInfo;
+    using RoutesInternalData = RoutesTable<TableWeight>;
+
+    SubsetRouter(const Graph& graph, std::vector<VertexId> vertices, size_t thread_count = 1);
+
+    // Восстанавливает маршрутизатор по ранее вычисленной таблице без повторного расчёта
+    SubsetRouter(const Graph& graph, std::vector<VertexId> vertices, RoutesInternalData routes_internal_data);
+
+    // Обе вершины должны входить в выделенное множество
+    std::optional<RouteInfo> BuildRoute(VertexId from, VertexId to) const override;
+
+    std::optional<Weight> BuildRouteEdges(VertexId from, VertexId to, std::vector<EdgeId>& edges,
+                                          SearchStats* stats) const override;
+
+    const RoutesInternalData& GetRoutesInternalData() const;
+
+private:
+    static constexpr TableWeight UNREACHABLE = RoutesInternalData::UNREACHABLE;
+    static constexpr uint32_t NO_PREV_EDGE = RoutesInternalData::NO_PREV_EDGE;
+    static constexpr size_t NO_INDEX = std::numeric_limits<size_t>::max();
+    static constexpr EdgeId NO_EDGE = std::numeric_limits<EdgeId>::max();
+
+    void IndexVertices(const Graph& graph) {
+        vertex_indexes_.assign(graph.GetVertexCount(), NO_INDEX);
+        for (size_t index = 0; index < vertices_.size(); ++index) {
+            vertex_indexes_.at(vertices_[index]) = index;
+        }
+        transit_in_edges_.assign(graph.GetVertexCount(), NO_EDGE);
+        for (EdgeId edge_id = 0; edge_id < graph.GetEdgeCount(); ++edge_id) {
+            const VertexId to = graph.GetEdge(edge_id).to;
+            if (vertex_indexes_[to] != NO_INDEX) {
+                continue;
+            }
+            if (transit_in_edges_[to] != NO_EDGE) {
+                throw std::invalid_argument("Transit vertices should have a single incoming edge");
+            }
+            transit_in_edges_[to] = edge_id;
+        }
+    }
+
+    // Заполняет таблицу составными рёбрами: из каждой выделенной вершины обходятся
+    // транзитные вершины до первой выделенной на каждом пути
+    void InitializeRoutesInternalData(const Graph& graph) {
+        const size_t subset_size = vertices_.size();
+        if (graph.GetEdgeCount() >= NO_PREV_EDGE) {
+            throw std::length_error("Too many edges for 32-bit edge ids");
+        }
+        std::vector<std::pair<VertexId, Weight>> stack;
+        for (size_t from_index = 0; from_index < subset_size; ++from_index) {
+            routes_internal_data_.weights[from_index * subset_size + from_index] = ZERO_WEIGHT;
+            stack.push_back({vertices_[from_index], Weight{}});
+            while (!stack.empty()) {
+                const auto [vertex, weight] = stack.back();
+                stack.pop_back();
+                for (const EdgeId edge_id : graph.GetIncidentEdges(vertex)) {
+                    const auto& edge = graph.GetEdge(edge_id);
+                    if (edge.weight < Weight{}) {
+                        throw std::domain_error("Edges' weights should be non-negative");
+                    }
+                    const size_t to_index = vertex_indexes_[edge.to];
+                    if (to_index == NO_INDEX) {
+                        stack.push_back({edge.to, weight + edge.weight});
+                        continue;
+                    }
+                    const size_t index = from_index * subset_size + to_index;
+                    const TableWeight route_weight = static_cast<TableWeight>(weight + edge.weight);
+                    if (routes_internal_data_.weights[index] > route_weight) {
+                        routes_internal_data_.weights[index] = route_weight;
+                        routes_internal_data_.prev_edges[index] = static_cast<uint32_t>(edge_id);
+                    }
+                }
+            }
+        }
+    }
+
+    static constexpr TableWeight ZERO_WEIGHT{};
+    const Graph& graph_;
+    std::vector<VertexId> vertices_;
+    std::vector<size_t> vertex_indexes_;
+    std::vector<EdgeId> transit_in_edges_;
+    RoutesInternalData routes_internal_data_;
+};
+
+template <typename Weight, typename TableWeight>
+SubsetRouter<Weight, TableWeight>::SubsetRouter(const Graph& graph, std::vector<VertexId> vertices, size_t thread_count)
+    : graph_(graph)
+    , vertices_(std::move(vertices))
+{
+    IndexVertices(graph);
+    const size_t subset_size = vertices_.size();
+    routes_internal_data_.weights.assign(subset_size * subset_size, UNREACHABLE);
+    routes_internal_data_.prev_edges.assign(subset_size * subset_size, NO_PREV_EDGE);
+    InitializeRoutesInternalData(graph);
+    detail::RelaxRoutesTable(routes_internal_data_, subset_size, std::max<size_t>(thread_count, 1));
+}
+
+template <typename Weight, typename TableWeight>
+SubsetRouter<Weight, TableWeight>::SubsetRouter(const Graph& graph, std::vector<VertexId> vertices,
+                                                RoutesInternalData routes_internal_data)
+    : graph_(graph)
+    , vertices_(std::move(vertices))
+    , routes_internal_data_(std::move(routes_internal_data))
+{
+    IndexVertices(graph);
+    const size_t cell_count = vertices_.size() * vertices_.size();
+    if (routes_internal_data_.weights.size() != cell_count || routes_internal_data_.prev_edges.size() != cell_count) {
+        throw std::invalid_argument("Routes internal data doesn't match the vertex subset");
+    }
+}
+
+template <typename Weight, typename TableWeight>
+const typename SubsetRouter<Weight, TableWeight>::RoutesInternalData&
+SubsetRouter<Weight, TableWeight>::GetRoutesInternalData() const {
+    return routes_internal_data_;
+}
+
+template <typename Weight, typename TableWeight>
+std::optional<typename SubsetRouter<Weight, TableWeight>::RouteInfo>
+SubsetRouter<Weight, TableWeight>::BuildRoute(VertexId from, VertexId to) const {
+    std::vector<EdgeId> edges;
+    const std::optional<Weight> weight = BuildRouteEdges(from, to, edges, nullptr);
+    if (!weight) {
+        return std::nullopt;
+    }
+    return RouteInfo{*weight, std::move(edges)};
+}
+
+template <typename Weight, typename TableWeight>
+std::optional<Weight> SubsetRouter<Weight, TableWeight>::BuildRouteEdges(VertexId from, VertexId to,
+                                                                         std::vector<EdgeId>& edges,
+                                                                         SearchStats* stats) const {
+    const size_t from_index = vertex_indexes_.at(from);
+    const size_t to_index = vertex_indexes_.at(to);
+    if (from_index == NO_INDEX || to_index == NO_INDEX) {
+        throw std::invalid_argument("Both vertices should belong to the router's subset");
+    }
+    if (stats != nullptr) {
+        *stats = {};
+    }
+    const size_t subset_size = vertices_.size();
+    const TableWeight* from_weights = routes_internal_data_.weights.data() + from_index * subset_size;
+    const uint32_t* from_prev_edges = routes_internal_data_.prev_edges.data() + from_index * subset_size;
+    edges.clear();
+    if (from_weights[to_index] == UNREACHABLE) {
+        return std::nullopt;
+    }
+
+    Weight weight = static_cast<Weight>(from_weights[to_index]);
+    for (uint32_t edge_id = from_prev_edges[to_index]; edge_id != NO_PREV_EDGE;) {
+        edges.push_back(edge_id);
+        VertexId vertex = graph_.GetEdge(edge_id).from;
+        while (vertex_indexes_[vertex] == NO_INDEX) {
+            edges.push_back(transit_in_edges_[vertex]);
+            vertex = graph_.GetEdge(transit_in_edges_[vertex]).from;
+        }
+        edge_id = from_prev_edges[vertex_indexes_[vertex]];
+    }
+    std::reverse(edges.begin(), edges.end());
+    if constexpr (!std::is_same_v<Weight, TableWeight>) {
+        // Таблица хранит веса с пониженной точностью, поэтому вес маршрута пересчитывается по рёбрам графа
+        weight = Weight{};
+        for (const EdgeId edge_id : edges) {
+            weight += graph_.GetEdge(edge_id).weight;
+        }
+    }
+    return weight;
+}
+
+}  // namespace graph
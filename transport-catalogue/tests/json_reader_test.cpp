@@ -0,0 +1,57 @@
+#include "json_reader.h"
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+namespace catalogue {
+namespace test {
+namespace {
+
+json::Document LoadJson(const std::string& text) {
+    std::istringstream input(text);
+    return json::Load(input);
+}
+
+TEST(JsonReaderTest, ReadsStopsDistancesAndBuses) {
+    const json::Document requests = LoadJson(R"([
+        {"type": "Bus", "name": "14", "stops": ["A", "B"], "is_roundtrip": false},
+        {"type": "Stop", "name": "A", "latitude": 55.6, "longitude": 37.5, "road_distances": {"B": 1200}},
+        {"type": "Stop", "name": "B", "latitude": 55.61, "longitude": 37.51, "road_distances": {}}
+    ])");
+    TransportCatalogue db;
+    json_rd::JsonReader reader(db);
+    reader.ReadBaseRequests(requests.GetRoot());
+
+    const Stop* a = db.GetStop("A");
+    const Stop* b = db.GetStop("B");
+    ASSERT_NE(a, nullptr);
+    ASSERT_NE(b, nullptr);
+    EXPECT_EQ(db.GetDistance(a, b), 1200);
+    EXPECT_EQ(db.GetKnownDistance(b->id, a->id), 1200);
+    const Bus* bus = db.GetBus("14");
+    ASSERT_NE(bus, nullptr);
+    EXPECT_EQ(std::vector<StopId>(bus->stops.begin(), bus->stops.end()), (std::vector<StopId>{a->id, b->id}));
+}
+
+TEST(JsonReaderTest, RejectsUnknownStops) {
+    const json::Document unknown_distance = LoadJson(R"([
+        {"type": "Stop", "name": "A", "latitude": 55.6, "longitude": 37.5, "road_distances": {"B": 1200}}
+    ])");
+    TransportCatalogue db;
+    json_rd::JsonReader reader(db);
+    EXPECT_THROW(reader.ReadBaseRequests(unknown_distance.GetRoot()), std::invalid_argument);
+
+    const json::Document unknown_bus_stop = LoadJson(R"([
+        {"type": "Bus", "name": "14", "stops": ["C"], "is_roundtrip": true}
+    ])");
+    TransportCatalogue other_db;
+    json_rd::JsonReader other_reader(other_db);
+    EXPECT_THROW(other_reader.ReadBaseRequests(unknown_bus_stop.GetRoot()), std::invalid_argument);
+}
+
+} // namespace
+} // namespace test
+} // namespace catalogue
@@ -0,0 +1,232 @@
+#include "request_handler.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <sstream>
+#include <string>
+
+namespace catalogue {
+namespace test {
+namespace {
+
+// Остановки A — B — C — D на одной линии и E без автобусов. Расстояние C -> B задано отдельно от B -> C,
+// а B -> A и D -> C берутся из обратного направления или заданы явно
+const std::string BASE_REQUESTS = R"("base_requests": [
+        {"type": "Bus", "name": "14", "stops": ["A", "B", "C"], "is_roundtrip": false},
+        {"type": "Bus", "name": "7", "stops": ["C", "D", "C"], "is_roundtrip": true},
+        {"type": "Stop", "name": "A", "latitude": 55.60, "longitude": 37.50, "road_distances": {"B": 1000}},
+        {"type": "Stop", "name": "B", "latitude": 55.61, "longitude": 37.50, "road_distances": {"C": 2000}},
+        {"type": "Stop", "name": "C", "latitude": 55.62, "longitude": 37.50, "road_distances": {"B": 1500, "D": 500}},
+        {"type": "Stop", "name": "D", "latitude": 55.62, "longitude": 37.51, "road_distances": {"C": 600}},
+        {"type": "Stop", "name": "E", "latitude": 55.63, "longitude": 37.51, "road_distances": {}}
+    ],
+    "render_settings": {
+        "width": 600, "height": 400, "padding": 50, "line_width": 14, "stop_radius": 5,
+        "bus_label_font_size": 20, "bus_label_offset": [7, 15], "stop_label_font_size": 20,
+        "stop_label_offset": [7, -3], "underlayer_color": [255, 255, 255, 0.85], "underlayer_width": 3,
+        "color_palette": ["green", [255, 160, 0], "red"]
+    },)";
+
+// Своя база у каждого теста, чтобы тесты можно было запускать параллельно
+std::string GetBasePath() {
+    const testing::TestInfo* test_info = testing::UnitTest::GetInstance()->current_test_info();
+    std::string name = std::string(test_info->test_suite_name()) + "." + test_info->name();
+    std::replace(name.begin(), name.end(), '/', '_');
+    return testing::TempDir() + name + ".db";
+}
+
+std::string MakeBaseInput(const std::string& router_mode) {
+    return "{" + BASE_REQUESTS + R"(
+        "routing_settings": {"bus_wait_time": 6, "bus_velocity": 40, "router_mode": ")" + router_mode + R"(",
+                             "profiles": {"express": {"bus_wait_time": 2, "bus_velocity": 60}}},
+        "serialization_settings": {"file": ")" + GetBasePath() + R"("}
+    })";
+}
+
+// Строит базу, как make_base, и отвечает на stat_requests по ней, как process_requests
+json::Array RunRequests(const std::string& router_mode, const std::string& stat_requests) {
+    {
+        TransportCatalogue catalogue;
+        json::Builder builder;
+        json_rd::JsonReader reader(catalogue);
+        renderer::MapRenderer renderer;
+        TransportRouter router(catalogue);
+        Serializer serializer(catalogue, renderer, router);
+        handler::RequestHandler handler(catalogue, builder, reader, renderer, router, serializer);
+        std::istringstream input(MakeBaseInput(router_mode));
+        handler.MakeBase(catalogue, input, renderer, router, serializer);
+    }
+    TransportCatalogue catalogue;
+    json::Builder builder;
+    json_rd::JsonReader reader(catalogue);
+    renderer::MapRenderer renderer;
+    TransportRouter router(catalogue);
+    Serializer serializer(catalogue, renderer, router);
+    handler::RequestHandler handler(catalogue, builder, reader, renderer, router, serializer);
+    std::istringstream input(R"({"serialization_settings": {"file": ")" + GetBasePath() + R"("},
+                                 "stat_requests": )" + stat_requests + "}");
+    std::ostringstream output;
+    handler.ProcessRequests(catalogue, input, output, router, serializer);
+    std::istringstream responses(output.str());
+    return json::Load(responses).GetRoot().AsArray();
+}
+
+class RequestHandlerTest : public testing::TestWithParam<std::string> {
+protected:
+    void TearDown() override {
+        std::remove(GetBasePath().c_str());
+    }
+};
+
+// Маршрутизатор каждого режима восстанавливается из базы и строит те же маршруты, что и при её создании:
+// 40 км/ч — 2000/3 м/мин, ожидание 6 мин
+TEST_P(RequestHandlerTest, RouterIsLoadedFromBase) {
+    const json::Array responses = RunRequests(GetParam(), R"([
+        {"id": 1, "type": "Route", "from": "A", "to": "C"},
+        {"id": 2, "type": "Route", "from": "C", "to": "A"},
+        {"id": 3, "type": "Route", "from": "A", "to": "D"},
+        {"id": 4, "type": "Route", "from": "A", "to": "E"},
+        {"id": 5, "type": "RouterStatus"}
+    ])");
+    ASSERT_EQ(responses.size(), 5u);
+    const json::Dict& route = responses[0].AsDict();
+    EXPECT_NEAR(route.at("total_time").AsDouble(), 6 + 4.5, 1e-9);
+    const json::Array& items = route.at("items").AsArray();
+    ASSERT_EQ(items.size(), 2u);
+    EXPECT_EQ(items[0].AsDict().at("type").AsString(), "Wait");
+    EXPECT_EQ(items[0].AsDict().at("stop_name").AsString(), "A");
+    EXPECT_EQ(items[1].AsDict().at("bus").AsString(), "14");
+    EXPECT_EQ(items[1].AsDict().at("span_count").AsInt(), 2);
+    EXPECT_NEAR(items[1].AsDict().at("time").AsDouble(), 4.5, 1e-9);
+    // Обратно через B едут 1500 м, а не 2000
+    EXPECT_NEAR(responses[1].AsDict().at("total_time").AsDouble(), 6 + 3.75, 1e-9);
+    EXPECT_NEAR(responses[2].AsDict().at("total_time").AsDouble(), 6 + 4.5 + 6 + 0.75, 1e-9);
+    EXPECT_EQ(responses[3].AsDict().at("error_message").AsString(), "not found");
+    EXPECT_TRUE(responses[4].AsDict().at("router_loaded").AsBool());
+}
+
+TEST_P(RequestHandlerTest, RouteMatrixAndIsochrone) {
+    const json::Array responses = RunRequests(GetParam(), R"([
+        {"id": 1, "type": "RouteMatrix", "from": ["A", "C"], "to": ["C", "A", "E"]},
+        {"id": 2, "type": "RouteMatrix", "from": ["A"], "to": ["C"], "with_items": true},
+        {"id": 3, "type": "RouteMatrix", "from": ["A"], "to": ["F"]},
+        {"id": 4, "type": "Isochrone", "from": "A", "max_time": 11}
+    ])");
+    ASSERT_EQ(responses.size(), 4u);
+    const json::Array& total_times = responses[0].AsDict().at("total_times").AsArray();
+    ASSERT_EQ(total_times.size(), 2u);
+    const json::Array& from_a = total_times[0].AsArray();
+    const json::Array& from_c = total_times[1].AsArray();
+    ASSERT_EQ(from_a.size(), 3u);
+    ASSERT_EQ(from_c.size(), 3u);
+    EXPECT_NEAR(from_a[0].AsDouble(), 10.5, 1e-9);
+    EXPECT_NEAR(from_a[1].AsDouble(), 0, 1e-9);
+    EXPECT_TRUE(from_a[2].IsNull());
+    EXPECT_NEAR(from_c[0].AsDouble(), 0, 1e-9);
+    EXPECT_NEAR(from_c[1].AsDouble(), 9.75, 1e-9);
+    EXPECT_TRUE(from_c[2].IsNull());
+
+    const json::Dict& with_items = responses[1].AsDict();
+    EXPECT_NEAR(with_items.at("total_times").AsArray()[0].AsArray()[0].AsDouble(), 10.5, 1e-9);
+    EXPECT_EQ(with_items.at("items").AsArray()[0].AsArray()[0].AsArray().size(), 2u);
+    EXPECT_EQ(responses[2].AsDict().at("error_message").AsString(), "not found");
+
+    std::map<std::string, double> reachable;
+    for (const auto& stop : responses[3].AsDict().at("stops").AsArray()) {
+        reachable[stop.AsDict().at("stop_name").AsString()] = stop.AsDict().at("time").AsDouble();
+    }
+    ASSERT_EQ(reachable.size(), 3u);
+    EXPECT_NEAR(reachable.at("A"), 0, 1e-9);
+    EXPECT_NEAR(reachable.at("B"), 7.5, 1e-9);
+    EXPECT_NEAR(reachable.at("C"), 10.5, 1e-9);
+}
+
+// Запросы к каталогу отвечаются до загрузки маршрутизатора, но ответы идут в порядке запросов
+TEST_P(RequestHandlerTest, MixedBatchKeepsRequestOrder) {
+    const json::Array responses = RunRequests(GetParam(), R"([
+        {"id": 10, "type": "Route", "from": "A", "to": "C"},
+        {"id": 11, "type": "Bus", "name": "14"},
+        {"id": 12, "type": "RouteTime", "from": "C", "to": "A"},
+        {"id": 13, "type": "Stop", "name": "C"},
+        {"id": 14, "type": "RouterStatus"},
+        {"id": 15, "type": "Bus", "name": "15"},
+        {"id": 16, "type": "Isochrone", "from": "E", "max_time": 5}
+    ])");
+    ASSERT_EQ(responses.size(), 7u);
+    for (size_t i = 0; i < responses.size(); ++i) {
+        EXPECT_EQ(responses[i].AsDict().at("request_id").AsInt(), static_cast<int>(10 + i));
+    }
+    EXPECT_NEAR(responses[2].AsDict().at("total_time").AsDouble(), 9.75, 1e-9);
+    const json::Array& buses = responses[3].AsDict().at("buses").AsArray();
+    ASSERT_EQ(buses.size(), 2u);
+    EXPECT_EQ(buses[0].AsString(), "14");
+    EXPECT_EQ(buses[1].AsString(), "7");
+    EXPECT_EQ(responses[5].AsDict().at("error_message").AsString(), "not found");
+    EXPECT_EQ(responses[6].AsDict().at("stops").AsArray().size(), 1u);
+}
+
+// Профиль из настроек и поля запроса меняют ожидание и скорость только для этого запроса
+TEST_P(RequestHandlerTest, PerRequestProfiles) {
+    const json::Array responses = RunRequests(GetParam(), R"([
+        {"id": 1, "type": "Route", "from": "A", "to": "C", "profile": "express"},
+        {"id": 2, "type": "Route", "from": "A", "to": "C", "bus_wait_time": 1},
+        {"id": 3, "type": "Route", "from": "A", "to": "C", "profile": "express", "bus_velocity": 30},
+        {"id": 4, "type": "Route", "from": "A", "to": "C", "profile": "night"},
+        {"id": 5, "type": "Route", "from": "A", "to": "C"}
+    ])");
+    ASSERT_EQ(responses.size(), 5u);
+    EXPECT_NEAR(responses[0].AsDict().at("total_time").AsDouble(), 2 + 3, 1e-9);
+    EXPECT_NEAR(responses[1].AsDict().at("total_time").AsDouble(), 1 + 4.5, 1e-9);
+    EXPECT_NEAR(responses[2].AsDict().at("total_time").AsDouble(), 2 + 6, 1e-9);
+    EXPECT_EQ(responses[3].AsDict().at("error_message").AsString(), "unknown profile");
+    EXPECT_NEAR(responses[4].AsDict().at("total_time").AsDouble(), 6 + 4.5, 1e-9);
+}
+
+// Статистика автобусов, сохранённая в базе, совпадает с посчитанной по каталогу
+TEST_P(RequestHandlerTest, StoredBusStatsMatchComputed) {
+    const json::Array responses = RunRequests(GetParam(), R"([
+        {"id": 1, "type": "Bus", "name": "14"},
+        {"id": 2, "type": "Bus", "name": "7"}
+    ])");
+    ASSERT_EQ(responses.size(), 2u);
+    // Туда 1000 + 2000, обратно 1500 + 1000; по кольцу 500 + 600
+    EXPECT_DOUBLE_EQ(responses[0].AsDict().at("route_length").AsDouble(), 5500);
+    EXPECT_EQ(responses[0].AsDict().at("stop_count").AsInt(), 5);
+    EXPECT_EQ(responses[0].AsDict().at("unique_stop_count").AsInt(), 3);
+    EXPECT_DOUBLE_EQ(responses[1].AsDict().at("route_length").AsDouble(), 1100);
+    EXPECT_EQ(responses[1].AsDict().at("stop_count").AsInt(), 3);
+    EXPECT_EQ(responses[1].AsDict().at("unique_stop_count").AsInt(), 2);
+
+    TransportCatalogue stored_db;
+    renderer::MapRenderer renderer;
+    TransportRouter router(stored_db);
+    Serializer serializer(stored_db, renderer, router);
+    serializer.SetSettings(GetBasePath());
+    serializer.DeserializeBase();
+
+    TransportCatalogue db;
+    json_rd::JsonReader reader(db);
+    std::istringstream base_input("{" + BASE_REQUESTS + R"("routing_settings": {}})");
+    reader.ReadBaseRequests(json::Load(base_input).GetRoot().AsDict().at("base_requests"));
+    ASSERT_EQ(stored_db.GetBusesCount(), db.GetBusesCount());
+    for (BusId bus = 0; bus < db.GetBusesCount(); ++bus) {
+        SCOPED_TRACE(std::string(db.GetBusById(bus)->name));
+        const BusStat stored = stored_db.GetBusStat(stored_db.GetBusById(bus));
+        const BusStat expected = db.GetBusStat(db.GetBusById(bus));
+        EXPECT_EQ(stored.stops_count, expected.stops_count);
+        EXPECT_EQ(stored.unique_stops_count, expected.unique_stops_count);
+        EXPECT_EQ(stored.route_length, expected.route_length);
+        EXPECT_EQ(stored.real_route_length, expected.real_route_length);
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(RouterModes, RequestHandlerTest,
+                         testing::Values("all_pairs", "dijkstra", "stop_pairs", "contraction_hierarchies", "a_star",
+                                         "raptor"));
+
+} // namespace
+} // namespace test
+} // namespace catalogue
@@ -0,0 +1,102 @@
+#include "route_cache.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+namespace catalogue {
+namespace test {
+namespace {
+
+class RouteCacheTest : public testing::Test {
+protected:
+    static RouteCache::Key MakeKey(StopId to) {
+        return RouteCache::MakeKey(0, to);
+    }
+
+    // Размер записи без маршрута, по нему задаётся ёмкость кэша в записях
+    static size_t GetEmptyEntrySize() {
+        RouteCache cache(1 << 20, 1);
+        cache.Put(MakeKey(0), std::nullopt);
+        return cache.GetStats().size_bytes;
+    }
+};
+
+// В одном сегменте вытесняется запись, к которой дольше всего не обращались
+TEST_F(RouteCacheTest, EvictsLeastRecentlyUsed) {
+    const size_t entry_size = GetEmptyEntrySize();
+    RouteCache cache(3 * entry_size, 1);
+    for (StopId to = 0; to < 3; ++to) {
+        cache.Put(MakeKey(to), std::nullopt);
+    }
+    EXPECT_TRUE(cache.Get(MakeKey(0)));
+    cache.Put(MakeKey(3), std::nullopt);
+
+    EXPECT_FALSE(cache.Get(MakeKey(1)));
+    EXPECT_TRUE(cache.Get(MakeKey(0)));
+    EXPECT_TRUE(cache.Get(MakeKey(2)));
+    EXPECT_TRUE(cache.Get(MakeKey(3)));
+    const RouteCacheStats stats = cache.GetStats();
+    EXPECT_EQ(stats.evictions, 1u);
+    EXPECT_EQ(stats.hits, 4u);
+    EXPECT_EQ(stats.misses, 1u);
+    EXPECT_EQ(stats.size_bytes, 3 * entry_size);
+}
+
+TEST_F(RouteCacheTest, ReplacesEntryAndKeepsMissingRoute) {
+    const size_t entry_size = GetEmptyEntrySize();
+    RouteCache cache(2 * entry_size, 1);
+    cache.Put(MakeKey(1), RouteItems{5, {}});
+    cache.Put(MakeKey(1), std::nullopt);
+    cache.Put(MakeKey(2), RouteItems{7, {}});
+
+    // Отсутствие маршрута — тоже ответ из кэша, в отличие от отсутствия записи
+    const std::optional<RouteCache::Value> missing_route = cache.Get(MakeKey(1));
+    ASSERT_TRUE(missing_route);
+    EXPECT_FALSE(*missing_route);
+    const std::optional<RouteCache::Value> route = cache.Get(MakeKey(2));
+    ASSERT_TRUE(route && *route);
+    EXPECT_EQ((*route)->total_time, 7);
+    EXPECT_EQ(cache.GetStats().evictions, 0u);
+}
+
+// Запись больше сегмента не вытесняет остальные и не сохраняется
+TEST_F(RouteCacheTest, SkipsEntryLargerThanShard) {
+    const size_t entry_size = GetEmptyEntrySize();
+    RouteCache cache(2 * entry_size, 1);
+    cache.Put(MakeKey(1), std::nullopt);
+    RouteItems long_route{10, std::vector<Item>(2 * entry_size / sizeof(Item) + 1, {ItemType::WAIT, "Stop 0", 6, 1})};
+    cache.Put(MakeKey(2), std::move(long_route));
+
+    EXPECT_FALSE(cache.Get(MakeKey(2)));
+    EXPECT_TRUE(cache.Get(MakeKey(1)));
+    EXPECT_EQ(cache.GetStats().evictions, 0u);
+}
+
+TEST_F(RouteCacheTest, EraseIfRemovesMatchingEntries) {
+    const size_t entry_size = GetEmptyEntrySize();
+    RouteCache cache(1 << 20);
+    for (StopId to = 0; to < 5; ++to) {
+        cache.Put(MakeKey(to), RouteItems{static_cast<double>(to), {}});
+    }
+    cache.EraseIf([](RouteCache::Key key, const RouteCache::Value& route) {
+        return RouteCache::GetTo(key) == 3 || (route && route->total_time < 1);
+    });
+
+    EXPECT_FALSE(cache.Get(MakeKey(0)));
+    EXPECT_FALSE(cache.Get(MakeKey(3)));
+    for (const StopId to : {1, 2, 4}) {
+        EXPECT_TRUE(cache.Get(MakeKey(to)));
+    }
+    const RouteCacheStats stats = cache.GetStats();
+    EXPECT_EQ(stats.size_bytes, 3 * entry_size);
+    EXPECT_EQ(stats.evictions, 0u);
+
+    cache.Clear();
+    EXPECT_FALSE(cache.Get(MakeKey(1)));
+    EXPECT_EQ(cache.GetStats().size_bytes, 0u);
+}
+
+} // namespace
+} // namespace test
+} // namespace catalogue
@@ -0,0 +1,60 @@
+#include "test_network.h"
+
+#include <gtest/gtest.h>
+
+namespace catalogue {
+namespace test {
+namespace {
+
+// Путь в одну сторону 0 -> 1 -> 2, цикл 3 <-> 4 и изолированная вершина 5
+TEST(RouteComponentsTest, OneWayPathsAreNotUnreachable) {
+    using Arc = graph::CsrGraph<double>::Arc;
+    const std::vector<Arc> arcs{{0, 1, 1.0, 0}, {1, 2, 1.0, 1}, {3, 4, 1.0, 2}, {4, 3, 1.0, 3}};
+    const graph::GraphComponents components = graph::ComputeGraphComponents(graph::CsrGraph<double>(6, arcs));
+    EXPECT_FALSE(components.IsUnreachable(0, 2));
+    EXPECT_TRUE(components.IsUnreachable(2, 0));
+    EXPECT_TRUE(components.IsUnreachable(1, 0));
+    EXPECT_FALSE(components.IsUnreachable(3, 4));
+    EXPECT_FALSE(components.IsUnreachable(4, 3));
+    EXPECT_TRUE(components.IsUnreachable(0, 3));
+    EXPECT_TRUE(components.IsUnreachable(5, 0));
+    EXPECT_FALSE(components.IsUnreachable(5, 5));
+}
+
+// Компоненты никогда не объявляют недостижимой пару, между которой есть маршрут, а пары из разных районов
+// и с необслуживаемыми остановками отсекаются без поиска
+TEST(RouteComponentsTest, UnreachableStopsHaveNoRoute) {
+    for (unsigned seed = 1; seed <= 4; ++seed) {
+        SCOPED_TRACE("seed " + std::to_string(seed));
+        std::mt19937 random(seed);
+        TransportCatalogue db;
+        FillRandomNetwork(db, random, 60, 24);
+        const auto reference = MakeRouter(db, MakeSettings(RouterMode::ALL_PAIRS));
+        const auto router = MakeRouter(db, MakeSettings(RouterMode::DIJKSTRA));
+        const graph::GraphComponents& components = router->GetComponents();
+        const auto& stop_vertexes = router->GetStopVertexes();
+        size_t unreachable_count = 0;
+        for (StopId from = 0; from < db.GetStopsCount(); ++from) {
+            for (StopId to = 0; to < db.GetStopsCount(); ++to) {
+                const Stop* start_stop = db.GetStopById(from);
+                const Stop* finish_stop = db.GetStopById(to);
+                SCOPED_TRACE(std::string(start_stop->name) + " -> " + std::string(finish_stop->name));
+                const bool is_unreachable = components.IsUnreachable(stop_vertexes[from].first,
+                                                                     stop_vertexes[to].first);
+                if (is_unreachable) {
+                    ++unreachable_count;
+                    EXPECT_FALSE(reference->GetRoute(start_stop, finish_stop));
+                    graph::SearchStats stats{1};
+                    EXPECT_FALSE(router->GetRoute(start_stop, finish_stop, &stats));
+                    EXPECT_EQ(stats.settled_vertices, 0u);
+                }
+            }
+        }
+        // Не меньше пар между двумя районами
+        EXPECT_GE(unreachable_count, 2 * 27 * 27u);
+    }
+}
+
+} // namespace
+} // namespace test
+} // namespace catalogue
@@ -0,0 +1,73 @@
+#include "router.h"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace graph {
+namespace {
+
+template <typename TableWeight>
+class RouterKernelsTest : public testing::Test {};
+
+using TableWeights = testing::Types<double, float>;
+TYPED_TEST_SUITE(RouterKernelsTest, TableWeights);
+
+// Строка из count весов, около четверти которых недоступны
+template <typename TableWeight>
+std::vector<TableWeight> MakeRow(std::mt19937& random, size_t count) {
+    std::uniform_real_distribution<TableWeight> weight(0, 100);
+    std::bernoulli_distribution is_unreachable(0.25);
+    std::vector<TableWeight> row(count);
+    for (TableWeight& value : row) {
+        value = is_unreachable(random) ? RoutesTable<TableWeight>::UNREACHABLE : weight(random);
+    }
+    return row;
+}
+
+std::vector<uint32_t> MakeEdges(std::mt19937& random, size_t count) {
+    std::uniform_int_distribution<uint32_t> edge(0, 1000);
+    std::vector<uint32_t> edges(count);
+    for (uint32_t& value : edges) {
+        value = edge(random);
+    }
+    return edges;
+}
+
+// Длины строк покрывают пустую строку, неполные векторы и хвосты после векторной части
+TYPED_TEST(RouterKernelsTest, Avx2MatchesScalarBitwise) {
+#ifdef TRANSPORT_CATALOGUE_ROUTER_AVX2
+    if (!detail::HasAvx2()) {
+        GTEST_SKIP() << "AVX2 is not supported by this CPU";
+    }
+    using TableWeight = TypeParam;
+    std::mt19937 random(42);
+    std::uniform_real_distribution<TableWeight> weight(0, 100);
+    for (size_t count = 0; count <= 37; ++count) {
+        for (const TableWeight weight_from : {TableWeight(0), weight(random), RoutesTable<TableWeight>::UNREACHABLE}) {
+            SCOPED_TRACE("count " + std::to_string(count) + ", weight_from " + std::to_string(weight_from));
+            const std::vector<TableWeight> through_weights = MakeRow<TableWeight>(random, count);
+            const std::vector<uint32_t> through_prev_edges = MakeEdges(random, count);
+            std::vector<TableWeight> scalar_weights = MakeRow<TableWeight>(random, count);
+            std::vector<uint32_t> scalar_prev_edges = MakeEdges(random, count);
+            std::vector<TableWeight> avx2_weights = scalar_weights;
+            std::vector<uint32_t> avx2_prev_edges = scalar_prev_edges;
+
+            detail::RelaxRoutesRowScalar(weight_from, through_weights.data(), through_prev_edges.data(),
+                                         scalar_weights.data(), scalar_prev_edges.data(), count);
+            detail::RelaxRoutesRowAvx2(weight_from, through_weights.data(), through_prev_edges.data(),
+                                       avx2_weights.data(), avx2_prev_edges.data(), count);
+
+            EXPECT_EQ(std::memcmp(avx2_weights.data(), scalar_weights.data(), count * sizeof(TableWeight)), 0);
+            EXPECT_EQ(avx2_prev_edges, scalar_prev_edges);
+        }
+    }
+#else
+    GTEST_SKIP() << "AVX2 kernels are not compiled for this target";
+#endif
+}
+
+}  // namespace
+}  // namespace graph
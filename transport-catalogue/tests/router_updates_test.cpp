@@ -0,0 +1,151 @@
+#include "test_network.h"
+
+#include <gtest/gtest.h>
+
+#include <limits>
+#include <stdexcept>
+
+namespace catalogue {
+namespace test {
+namespace {
+
+// A -> C: пересадка на B за 18 минут или прямой медленный автобус за 21 минуту
+void FillTransferNetwork(TransportCatalogue& db) {
+    db.AddStop(Stop("A", {55.60, 37.50}));
+    db.AddStop(Stop("B", {55.61, 37.51}));
+    db.AddStop(Stop("C", {55.62, 37.52}));
+    const Stop* a = db.GetStop("A");
+    const Stop* b = db.GetStop("B");
+    const Stop* c = db.GetStop("C");
+    db.SetDistance(a, b, 2000);
+    db.SetDistance(b, c, 2000);
+    db.SetDistance(a, c, 10000);
+    db.AddBus("1", {a->id, b->id}, false);
+    db.AddBus("2", {b->id, c->id}, false);
+    db.AddBus("3", {a->id, c->id}, false);
+}
+
+class RouterUpdatesTest : public testing::TestWithParam<RouterMode> {};
+
+TEST_P(RouterUpdatesTest, ClosureAndSlowdownChangeRoute) {
+    TransportCatalogue db;
+    FillTransferNetwork(db);
+    const auto router = MakeRouter(db, MakeSettings(GetParam()));
+    const Stop* a = db.GetStop("A");
+    const Stop* b = db.GetStop("B");
+    const Stop* c = db.GetStop("C");
+    const Bus* bus = db.GetBus("3");
+
+    std::optional<RouteItems> route = router->GetRoute(a, c);
+    ASSERT_TRUE(route);
+    EXPECT_DOUBLE_EQ(route->total_time, 18);
+    EXPECT_EQ(route->items.size(), 4u);
+
+    // На закрытой B нельзя пересесть
+    router->SetStopClosed(b, true);
+    route = router->GetRoute(a, c);
+    ASSERT_TRUE(route);
+    EXPECT_DOUBLE_EQ(route->total_time, 21);
+    ASSERT_EQ(route->items.size(), 2u);
+    EXPECT_EQ(route->items[1].name, "3");
+    EXPECT_FALSE(router->GetRoute(a, b));
+    EXPECT_EQ(router->GetRouteTime(a, c), 21);
+
+    // Выключенный автобус не возит совсем
+    router->SetBusTimeFactor(bus, std::numeric_limits<double>::infinity());
+    EXPECT_FALSE(router->GetRoute(a, c));
+
+    // Ускоренный вдвое прямой автобус выгоднее пересадки и после открытия B
+    router->SetStopClosed(b, false);
+    router->SetBusTimeFactor(bus, 0.5);
+    route = router->GetRoute(a, c);
+    ASSERT_TRUE(route);
+    EXPECT_DOUBLE_EQ(route->total_time, 13.5);
+
+    router->SetBusTimeFactor(bus, 1);
+    EXPECT_EQ(router->GetChangedEdgeCount(), 0u);
+    route = router->GetRoute(a, c);
+    ASSERT_TRUE(route);
+    EXPECT_DOUBLE_EQ(route->total_time, 18);
+}
+
+// Ребро поездки с нулевым расстоянием выключенного автобуса удаляется, а не получает вес NaN
+TEST_P(RouterUpdatesTest, DisabledBusDropsZeroWeightEdges) {
+    TransportCatalogue db;
+    db.AddStop(Stop("A", {55.60, 37.50}));
+    db.AddStop(Stop("B", {55.60, 37.50}));
+    const Stop* a = db.GetStop("A");
+    const Stop* b = db.GetStop("B");
+    db.SetDistance(a, b, 0);
+    db.AddBus("0", {a->id, b->id}, false);
+    const auto router = MakeRouter(db, MakeSettings(GetParam()));
+    ASSERT_TRUE(router->GetRoute(a, b));
+
+    router->SetBusTimeFactor(db.GetBus("0"), std::numeric_limits<double>::infinity());
+    EXPECT_FALSE(router->GetRoute(a, b));
+    EXPECT_FALSE(router->GetRouteTime(a, b));
+    EXPECT_EQ(router->GetChangedEdgeCount(), 2u);
+}
+
+INSTANTIATE_TEST_SUITE_P(GraphModes, RouterUpdatesTest,
+                         testing::Values(RouterMode::ALL_PAIRS, RouterMode::DIJKSTRA, RouterMode::STOP_PAIRS,
+                                         RouterMode::CONTRACTION_HIERARCHIES, RouterMode::A_STAR),
+                         [](const testing::TestParamInfo<RouterMode>& info) {
+                             switch (info.param) {
+                                 case RouterMode::ALL_PAIRS: return "AllPairs";
+                                 case RouterMode::DIJKSTRA: return "Dijkstra";
+                                 case RouterMode::STOP_PAIRS: return "StopPairs";
+                                 case RouterMode::CONTRACTION_HIERARCHIES: return "ContractionHierarchies";
+                                 case RouterMode::A_STAR: return "AStar";
+                                 case RouterMode::RAPTOR: return "Raptor";
+                             }
+                             return "Unknown";
+                         });
+
+TEST(RouterUpdatesRaptorTest, UpdatesAreRejected) {
+    TransportCatalogue db;
+    FillTransferNetwork(db);
+    const auto router = MakeRouter(db, MakeSettings(RouterMode::RAPTOR));
+    EXPECT_THROW(router->SetStopClosed(db.GetStop("B"), true), std::logic_error);
+    EXPECT_THROW(router->SetBusTimeFactor(db.GetBus("3"), 2), std::logic_error);
+}
+
+// Таблица с заполненным кэшем после каждого изменения отвечает так же, как поиск Дейкстры по текущим весам:
+// предвычисленные маршруты не используются через изменённые рёбра, а затронутые записи уходят из кэша
+TEST(RouterUpdatesRandomTest, CachedTableMatchesDijkstra) {
+    for (unsigned seed = 1; seed <= 4; ++seed) {
+        SCOPED_TRACE("seed " + std::to_string(seed));
+        std::mt19937 random(seed);
+        TransportCatalogue db;
+        FillRandomNetwork(db, random, 40, 16);
+        RouterSettings table_settings = MakeSettings(RouterMode::ALL_PAIRS);
+        table_settings.route_cache_size = 1 << 20;
+        const auto table_router = MakeRouter(db, table_settings);
+        const auto dijkstra_router = MakeRouter(db, MakeSettings(RouterMode::DIJKSTRA));
+
+        std::uniform_int_distribution<StopId> stop(0, static_cast<StopId>(db.GetStopsCount() - 1));
+        std::uniform_real_distribution<double> time_factor(0.5, 3.0);
+        const std::vector<const Bus*>& buses = db.GetAllBuses();
+        std::uniform_int_distribution<size_t> bus_index(0, buses.size() - 1);
+        for (int update = 0; update < 6; ++update) {
+            SCOPED_TRACE("update " + std::to_string(update));
+            ExpectSameRoutes(db, *dijkstra_router, *table_router);
+            const Stop* closed_stop = db.GetStopById(stop(random));
+            const bool closed = update % 3 != 2;
+            table_router->SetStopClosed(closed_stop, closed);
+            dijkstra_router->SetStopClosed(closed_stop, closed);
+            const Bus* bus = buses[bus_index(random)];
+            const double factor = update == 4 ? std::numeric_limits<double>::infinity() : time_factor(random);
+            table_router->SetBusTimeFactor(bus, factor);
+            dijkstra_router->SetBusTimeFactor(bus, factor);
+        }
+        ExpectSameRoutes(db, *dijkstra_router, *table_router);
+        const std::optional<RouteCacheStats> cache_stats = table_router->GetRouteCacheStats();
+        ASSERT_TRUE(cache_stats);
+        EXPECT_GT(cache_stats->hits, 0u);
+    }
+}
+
+} // namespace
+} // namespace test
+} // namespace catalogue
@@ -0,0 +1,126 @@
+#include "test_network.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace catalogue {
+namespace test {
+namespace {
+
+constexpr size_t STOP_COUNT = 60;
+constexpr size_t BUS_COUNT = 24;
+
+// Маршруты движка mode на нескольких случайных сетях совпадают с таблицей all_pairs
+void ExpectModeMatchesAllPairs(RouterSettings settings, double tolerance = 1e-9) {
+    for (unsigned seed = 1; seed <= 4; ++seed) {
+        SCOPED_TRACE("seed " + std::to_string(seed));
+        std::mt19937 random(seed);
+        TransportCatalogue db;
+        FillRandomNetwork(db, random, STOP_COUNT, BUS_COUNT);
+        const auto reference = MakeRouter(db, MakeSettings(RouterMode::ALL_PAIRS));
+        const auto router = MakeRouter(db, settings);
+        ExpectSameRoutes(db, *reference, *router, tolerance);
+    }
+}
+
+TEST(RoutingEnginesTest, DijkstraMatchesAllPairs) {
+    ExpectModeMatchesAllPairs(MakeSettings(RouterMode::DIJKSTRA));
+}
+
+TEST(RoutingEnginesTest, StopPairsMatchesAllPairs) {
+    ExpectModeMatchesAllPairs(MakeSettings(RouterMode::STOP_PAIRS));
+}
+
+TEST(RoutingEnginesTest, ContractionHierarchiesMatchesAllPairs) {
+    ExpectModeMatchesAllPairs(MakeSettings(RouterMode::CONTRACTION_HIERARCHIES));
+}
+
+TEST(RoutingEnginesTest, AStarMatchesAllPairs) {
+    ExpectModeMatchesAllPairs(MakeSettings(RouterMode::A_STAR));
+}
+
+TEST(RoutingEnginesTest, RaptorMatchesAllPairs) {
+    ExpectModeMatchesAllPairs(MakeSettings(RouterMode::RAPTOR));
+}
+
+// Веса во float дают относительную погрешность порядка 1e-7 на каждое сложение
+TEST(RoutingEnginesTest, CompactTableMatchesAllPairs) {
+    for (const RouterMode mode : {RouterMode::ALL_PAIRS, RouterMode::STOP_PAIRS}) {
+        RouterSettings settings = MakeSettings(mode);
+        settings.compact_table = true;
+        ExpectModeMatchesAllPairs(settings, 1e-5);
+    }
+}
+
+// Время в пути по меткам-хабам совпадает со временем маршрута в таблице, в том числе отсутствие маршрута
+TEST(RoutingEnginesTest, HubLabelsMatchAllPairs) {
+    for (unsigned seed = 1; seed <= 4; ++seed) {
+        SCOPED_TRACE("seed " + std::to_string(seed));
+        std::mt19937 random(seed);
+        TransportCatalogue db;
+        FillRandomNetwork(db, random, STOP_COUNT, BUS_COUNT);
+        const auto reference = MakeRouter(db, MakeSettings(RouterMode::ALL_PAIRS));
+        RouterSettings settings = MakeSettings(RouterMode::DIJKSTRA);
+        settings.hub_labels = true;
+        const auto router = MakeRouter(db, settings);
+        ASSERT_NE(router->GetHubLabelsData(), nullptr);
+        for (StopId from = 0; from < db.GetStopsCount(); ++from) {
+            for (StopId to = 0; to < db.GetStopsCount(); ++to) {
+                const Stop* start_stop = db.GetStopById(from);
+                const Stop* finish_stop = db.GetStopById(to);
+                SCOPED_TRACE(std::string(start_stop->name) + " -> " + std::string(finish_stop->name));
+                const std::optional<RouteItems> expected = reference->GetRoute(start_stop, finish_stop);
+                const std::optional<double> time = router->GetRouteTime(start_stop, finish_stop);
+                ASSERT_EQ(time.has_value(), expected.has_value());
+                if (expected) {
+                    EXPECT_NEAR(*time, expected->total_time, 1e-9 * std::max(1.0, expected->total_time));
+                }
+            }
+        }
+    }
+}
+
+// Матрица маршрутов совпадает с отдельными маршрутами таблицы; у иерархии сжатия без элементов
+// она строится корзинным поиском, с элементами — по строкам
+TEST(RoutingEnginesTest, RouteMatrixMatchesAllPairs) {
+    std::mt19937 random(5);
+    TransportCatalogue db;
+    FillRandomNetwork(db, random, STOP_COUNT, BUS_COUNT);
+    std::vector<const Stop*> stops;
+    for (StopId stop = 0; stop < db.GetStopsCount(); ++stop) {
+        stops.push_back(db.GetStopById(stop));
+    }
+    const auto reference = MakeRouter(db, MakeSettings(RouterMode::ALL_PAIRS));
+    for (const RouterMode mode : {RouterMode::ALL_PAIRS, RouterMode::DIJKSTRA, RouterMode::CONTRACTION_HIERARCHIES}) {
+        const auto router = MakeRouter(db, MakeSettings(mode));
+        for (const bool with_items : {false, true}) {
+            SCOPED_TRACE("mode " + std::to_string(static_cast<int>(mode)) + (with_items ? " with items" : ""));
+            const auto matrix = router->GetRouteMatrix(stops, stops, with_items);
+            ASSERT_EQ(matrix.size(), stops.size());
+            for (size_t from = 0; from < stops.size(); ++from) {
+                ASSERT_EQ(matrix[from].size(), stops.size());
+                for (size_t to = 0; to < stops.size(); ++to) {
+                    const std::optional<RouteItems> expected = reference->GetRoute(stops[from], stops[to]);
+                    const std::optional<RouteItems>& route = matrix[from][to];
+                    ASSERT_EQ(route.has_value(), expected.has_value()) << from << " -> " << to;
+                    if (!expected) {
+                        continue;
+                    }
+                    EXPECT_NEAR(route->total_time, expected->total_time, 1e-9 * std::max(1.0, expected->total_time));
+                    if (with_items) {
+                        EXPECT_NEAR(GetItemsTime(*route), route->total_time, 1e-9 * std::max(1.0, route->total_time));
+                    } else {
+                        EXPECT_TRUE(route->items.empty());
+                    }
+                }
+            }
+        }
+    }
+}
+
+} // namespace
+} // namespace test
+} // namespace catalogue
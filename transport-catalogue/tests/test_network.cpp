@@ -0,0 +1,117 @@
+#include "test_network.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+namespace catalogue {
+namespace test {
+
+void FillRandomNetwork(TransportCatalogue& db, std::mt19937& random, size_t stop_count, size_t bus_count) {
+    std::uniform_real_distribution<double> coordinate(0.0, 0.05);
+    for (size_t stop = 0; stop < stop_count; ++stop) {
+        db.AddStop(Stop("Stop " + std::to_string(stop), {55.6 + coordinate(random), 37.5 + coordinate(random)}));
+    }
+    // Последняя десятая часть остановок не обслуживается, остальные делятся на два района
+    const size_t served_count = stop_count - stop_count / 10;
+    const size_t district_size = served_count / 2;
+    std::uniform_int_distribution<int> distance(100, 3000);
+    std::bernoulli_distribution coin(0.5);
+    for (size_t bus = 0; bus < bus_count; ++bus) {
+        const size_t district_begin = bus % 2 == 0 ? 0 : district_size;
+        const size_t district_end = bus % 2 == 0 ? district_size : served_count;
+        std::uniform_int_distribution<size_t> stop_in_district(district_begin, district_end - 1);
+        std::uniform_int_distribution<size_t> route_size(2, 7);
+        std::vector<StopId> stops(route_size(random));
+        for (StopId& stop : stops) {
+            stop = static_cast<StopId>(stop_in_district(random));
+        }
+        const bool is_roundtrip = coin(random);
+        if (is_roundtrip) {
+            stops.push_back(stops.front());
+        }
+        for (size_t i = 0; i + 1 < stops.size(); ++i) {
+            const Stop* from = db.GetStopById(stops[i]);
+            const Stop* to = db.GetStopById(stops[i + 1]);
+            if (!db.GetDistance(from, to)) {
+                db.SetDistance(from, to, distance(random));
+            }
+            if (coin(random)) {
+                db.SetDistance(to, from, distance(random));
+            }
+        }
+        db.AddBus("Bus " + std::to_string(bus), stops, is_roundtrip);
+    }
+}
+
+RouterSettings MakeSettings(RouterMode mode) {
+    RouterSettings settings;
+    settings.time = 6;
+    settings.velocity = 40.0;
+    settings.mode = mode;
+    return settings;
+}
+
+std::unique_ptr<TransportRouter> MakeRouter(const TransportCatalogue& db, RouterSettings settings) {
+    auto router = std::make_unique<TransportRouter>(db);
+    router->SetSettings(std::move(settings));
+    router->BuildAllRoutes();
+    return router;
+}
+
+double GetItemsTime(const RouteItems& route) {
+    double time = 0;
+    for (const Item& item : route.items) {
+        time += item.time;
+    }
+    return time;
+}
+
+namespace {
+
+void ExpectValidItems(const Stop* start_stop, const std::vector<Item>& items, double total_time, double tolerance) {
+    ASSERT_EQ(items.size() % 2, 0u);
+    for (size_t i = 0; i < items.size(); ++i) {
+        EXPECT_EQ(items[i].type, i % 2 == 0 ? ItemType::WAIT : ItemType::BUS);
+    }
+    if (!items.empty()) {
+        EXPECT_EQ(items.front().name, start_stop->name);
+    }
+    double time = 0;
+    for (const Item& item : items) {
+        time += item.time;
+    }
+    EXPECT_NEAR(time, total_time, tolerance * std::max(1.0, total_time));
+}
+
+} // namespace
+
+void ExpectSameRoutes(const TransportCatalogue& db, const TransportRouter& reference, const TransportRouter& router,
+                      double tolerance) {
+    RouteBuffer buffer;
+    for (StopId from = 0; from < db.GetStopsCount(); ++from) {
+        for (StopId to = 0; to < db.GetStopsCount(); ++to) {
+            const Stop* start_stop = db.GetStopById(from);
+            const Stop* finish_stop = db.GetStopById(to);
+            SCOPED_TRACE(std::string(start_stop->name) + " -> " + std::string(finish_stop->name));
+            const std::optional<RouteItems> expected = reference.GetRoute(start_stop, finish_stop);
+            const std::optional<RouteItems> route = router.GetRoute(start_stop, finish_stop);
+            ASSERT_EQ(route.has_value(), expected.has_value());
+            const std::optional<double> buffer_time = router.GetRoute(start_stop, finish_stop, buffer);
+            ASSERT_EQ(buffer_time.has_value(), expected.has_value());
+            if (!expected) {
+                continue;
+            }
+            const double allowed_error = tolerance * std::max(1.0, expected->total_time);
+            EXPECT_NEAR(route->total_time, expected->total_time, allowed_error);
+            EXPECT_NEAR(*buffer_time, expected->total_time, allowed_error);
+            ExpectValidItems(start_stop, route->items, route->total_time, tolerance);
+            ExpectValidItems(start_stop, buffer.items, *buffer_time, tolerance);
+        }
+    }
+}
+
+} // namespace test
+} // namespace catalogue
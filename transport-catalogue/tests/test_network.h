@@ -0,0 +1,28 @@
+#pragma once
+#include "transport_router.h"
+
+#include <memory>
+#include <random>
+
+namespace catalogue {
+namespace test {
+
+// Случайная транспортная сеть из двух не связанных между собой районов: автобусы ходят только внутри
+// своего района, часть остановок не обслуживается ни одним автобусом, кольцевые маршруты дают пути в одну
+// сторону, а расстояния в обратную сторону задаются не всегда и могут отличаться от прямых
+void FillRandomNetwork(TransportCatalogue& db, std::mt19937& random, size_t stop_count, size_t bus_count);
+
+// Настройки с основным профилем 6 минут ожидания и 40 км/ч
+RouterSettings MakeSettings(RouterMode mode);
+
+std::unique_ptr<TransportRouter> MakeRouter(const TransportCatalogue& db, RouterSettings settings);
+
+double GetItemsTime(const RouteItems& route);
+
+// Сравнивает маршруты router и reference между всеми парами остановок: совпадают наличие маршрута
+// и время в пути с относительной точностью tolerance, а время элементов маршрута router равно его total_time
+void ExpectSameRoutes(const TransportCatalogue& db, const TransportRouter& reference, const TransportRouter& router,
+                      double tolerance = 1e-9);
+
+} // namespace test
+} // namespace catalogue
@@ -0,0 +1,50 @@
+#include "thread_pool.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace parallel {
+namespace {
+
+TEST(ThreadPoolTest, RunsEveryTaskOnce) {
+    ThreadPool pool(4);
+    std::vector<std::atomic<int>> calls(1000);
+    pool.ParallelFor(calls.size(), [&calls](size_t i) {
+        ++calls[i];
+    });
+    for (const auto& count : calls) {
+        EXPECT_EQ(count, 1);
+    }
+}
+
+// Исключение из задачи выбрасывается вызывающему потоку, а пул остаётся пригодным для следующих вызовов
+TEST(ThreadPoolTest, RethrowsTaskException) {
+    for (const size_t thread_count : {1, 4}) {
+        SCOPED_TRACE("threads " + std::to_string(thread_count));
+        ThreadPool pool(thread_count);
+        std::atomic<size_t> started = 0;
+        EXPECT_THROW(pool.ParallelFor(1000, [&started](size_t i) {
+            ++started;
+            if (i == 10) {
+                throw std::invalid_argument("task failed");
+            }
+        }), std::invalid_argument);
+        // Без дополнительных потоков задачи после выбросившей исключение не начинаются
+        if (thread_count == 1) {
+            EXPECT_EQ(started, 11u);
+        }
+
+        std::atomic<size_t> finished = 0;
+        pool.ParallelFor(100, [&finished](size_t) {
+            ++finished;
+        });
+        EXPECT_EQ(finished, 100u);
+    }
+}
+
+} // namespace
+} // namespace parallel
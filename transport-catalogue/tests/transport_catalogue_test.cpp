@@ -0,0 +1,73 @@
+#include "test_network.h"
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace catalogue {
+namespace test {
+namespace {
+
+// Обратное расстояние используется, только пока не задано своё, и не заменяет прямое
+TEST(DistanceTableTest, FallsBackToReverseDirection) {
+    DistanceTable distances;
+    distances.Set(0, 1, 100);
+    EXPECT_EQ(distances.Get(0, 1), 100);
+    EXPECT_EQ(distances.Get(1, 0), 100);
+    EXPECT_FALSE(distances.Get(0, 2));
+
+    distances.Set(1, 0, 150);
+    EXPECT_EQ(distances.Get(0, 1), 100);
+    EXPECT_EQ(distances.Get(1, 0), 150);
+    distances.Set(0, 1, 120);
+    EXPECT_EQ(distances.Get(0, 1), 120);
+    EXPECT_EQ(distances.Get(1, 0), 150);
+    EXPECT_EQ(distances.GetSize(), 2u);
+}
+
+// После многократного роста таблицы находятся все расстояния в обе стороны
+TEST(DistanceTableTest, KeepsDistancesWhenGrowing) {
+    constexpr StopId STOP_COUNT = 1000;
+    DistanceTable distances;
+    for (StopId stop = 0; stop + 1 < STOP_COUNT; ++stop) {
+        distances.Set(stop, stop + 1, stop);
+        if (stop % 3 == 0) {
+            distances.Set(stop + 1, stop, stop + STOP_COUNT);
+        }
+    }
+    for (StopId stop = 0; stop + 1 < STOP_COUNT; ++stop) {
+        EXPECT_EQ(distances.Get(stop, stop + 1), stop);
+        EXPECT_EQ(distances.Get(stop + 1, stop), stop % 3 == 0 ? stop + STOP_COUNT : stop);
+        EXPECT_FALSE(distances.Get(stop, stop + 2));
+    }
+    size_t count = 0;
+    distances.ForEach([&count](StopId, StopId, int64_t) { ++count; });
+    EXPECT_EQ(count, distances.GetSize());
+}
+
+// Параллельно посчитанная статистика совпадает со статистикой, которую каталог считает на месте
+TEST(TransportCatalogueTest, ComputedBusStatsMatchOnDemand) {
+    std::mt19937 random(3);
+    TransportCatalogue db;
+    FillRandomNetwork(db, random, 60, 24);
+    std::vector<BusStat> expected;
+    for (BusId bus = 0; bus < db.GetBusesCount(); ++bus) {
+        expected.push_back(db.GetBusStat(db.GetBusById(bus)));
+    }
+    db.ComputeBusStats(4);
+    for (BusId bus = 0; bus < db.GetBusesCount(); ++bus) {
+        SCOPED_TRACE(std::string(db.GetBusById(bus)->name));
+        const BusStat stat = db.GetBusStat(db.GetBusById(bus));
+        EXPECT_EQ(stat.stops_count, expected[bus].stops_count);
+        EXPECT_EQ(stat.unique_stops_count, expected[bus].unique_stops_count);
+        EXPECT_EQ(stat.route_length, expected[bus].route_length);
+        EXPECT_EQ(stat.real_route_length, expected[bus].real_route_length);
+    }
+    EXPECT_THROW(db.SetBusStats(std::vector<BusStat>(db.GetBusesCount() + 1)), std::invalid_argument);
+}
+
+} // namespace
+} // namespace test
+} // namespace catalogue
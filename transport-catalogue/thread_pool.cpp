@@ -0,0 +1,94 @@
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace parallel {
+
+ThreadPool::ThreadPool(size_t thread_count) {
+    for (size_t i = 1; i < thread_count; ++i) {
+        workers_.emplace_back([this] { WorkerLoop(); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard lock(mutex_);
+        stopping_ = true;
+    }
+    task_ready_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+size_t ThreadPool::GetThreadCount() const {
+    return workers_.size() + 1;
+}
+
+void ThreadPool::ParallelFor(size_t count, const std::function<void(size_t)>& func) {
+    if (count == 0) { return; }
+    if (workers_.empty() || count == 1) {
+        for (size_t i = 0; i < count; ++i) {
+            func(i);
+        }
+        return;
+    }
+    {
+        std::lock_guard lock(mutex_);
+        func_ = &func;
+        count_ = count;
+        next_index_ = 0;
+        active_workers_ = workers_.size();
+        error_ = nullptr;
+        ++generation_;
+    }
+    task_ready_.notify_all();
+    RunTasks();
+
+    std::unique_lock lock(mutex_);
+    task_done_.wait(lock, [this] { return active_workers_ == 0; });
+    func_ = nullptr;
+    if (error_) {
+        std::rethrow_exception(std::exchange(error_, nullptr));
+    }
+}
+
+void ThreadPool::WorkerLoop() {
+    uint64_t seen_generation = 0;
+    while (true) {
+        std::unique_lock lock(mutex_);
+        task_ready_.wait(lock, [this, seen_generation] { return stopping_ || generation_ != seen_generation; });
+        if (stopping_) { return; }
+        seen_generation = generation_;
+        lock.unlock();
+
+        RunTasks();
+
+        lock.lock();
+        if (--active_workers_ == 0) {
+            task_done_.notify_all();
+        }
+    }
+}
+
+void ThreadPool::RunTasks() {
+    try {
+        for (size_t i = next_index_++; i < count_; i = next_index_++) {
+            (*func_)(i);
+        }
+    } catch (...) {
+        // Оставшиеся задачи не раздаются; вызывающий поток перебросит первое исключение после остановки всех
+        next_index_ = count_;
+        std::lock_guard lock(mutex_);
+        if (!error_) {
+            error_ = std::current_exception();
+        }
+    }
+}
+
+size_t GetDefaultThreadCount() {
+    return std::max<size_t>(std::thread::hardware_concurrency(), 1);
+}
+
+} // namespace parallel
\ No newline at end of file
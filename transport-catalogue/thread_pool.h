@@ -0,0 +1,55 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace parallel {
+
+// Пул потоков для параллельной обработки набора независимых задач.
+// Вызывающий поток участвует в работе, поэтому пул на thread_count потоков
+// запускает thread_count - 1 дополнительных
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t thread_count);
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool();
+
+    size_t GetThreadCount() const;
+
+    // Вызывает func(i) для каждого i из [0, count) и дожидается завершения всех вызовов.
+    // Если какой-то вызов выбросил исключение, оставшиеся не начинаются, а первое исключение
+    // выбрасывается из ParallelFor после завершения уже начатых вызовов
+    void ParallelFor(size_t count, const std::function<void(size_t)>& func);
+
+private:
+    void WorkerLoop();
+
+    void RunTasks();
+
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable task_ready_;
+    std::condition_variable task_done_;
+    const std::function<void(size_t)>* func_ = nullptr;
+    size_t count_ = 0;
+    std::atomic<size_t> next_index_{0};
+    size_t active_workers_ = 0;
+    uint64_t generation_ = 0;
+    // Первое исключение текущего ParallelFor
+    std::exception_ptr error_;
+    bool stopping_ = false;
+};
+
+// Число потоков по умолчанию — по числу аппаратных потоков, но не меньше одного
+size_t GetDefaultThreadCount();
+
+} // namespace parallel
\ No newline at end of file
@@ -5,95 +5,164 @@ using namespace std;
     
 void TransportCatalogue::AddStop(const Stop& stop) {
     stops_.push_back(stop);
-    stop_names_to_ptrs_[stops_.back().name] = &stops_.back();
+    stops_.back().name = names_.Store(stop.name);
+    stops_.back().id = static_cast<StopId>(stops_.size() - 1);
+    stop_ids_[stops_.back().name] = stops_.back().id;
+    stop_coordinates_.push_back(stop.coordinates);
+    stop_to_buses_.emplace_back();
 }
 
-void TransportCatalogue::AddBus(const Bus& bus) {
-    buses_.push_back(bus);
-    bus_names_to_ptrs_[buses_.back().name] = &buses_.back();
+void TransportCatalogue::AddBus(string_view name, const vector<StopId>& stops, bool is_roundtrip) {
+    const StopId* previous_data = bus_stops_.data();
+    bus_stops_.insert(bus_stops_.end(), stops.begin(), stops.end());
+    bus_stop_offsets_.push_back(static_cast<uint32_t>(bus_stops_.size()));
+    if (bus_stops_.data() != previous_data) {
+        for (Bus& bus : buses_) {
+            bus.stops = {bus_stops_.data() + bus_stop_offsets_[bus.id], bus_stops_.data() + bus_stop_offsets_[bus.id + 1]};
+        }
+    }
+    buses_.emplace_back();
+    buses_.back().name = names_.Store(name);
+    buses_.back().stops = {bus_stops_.data() + bus_stop_offsets_[buses_.size() - 1], bus_stops_.data() + bus_stops_.size()};
+    buses_.back().is_roundtrip = is_roundtrip;
+    buses_.back().id = static_cast<BusId>(buses_.size() - 1);
+    bus_ids_[buses_.back().name] = buses_.back().id;
+    const string_view bus_name = buses_.back().name;
+    const auto sorted_it = lower_bound(sorted_buses_.begin(), sorted_buses_.end(), bus_name,
+                                       [](const Bus* lhs, string_view name) { return lhs->name < name; });
+    if (sorted_it != sorted_buses_.end() && (*sorted_it)->name == bus_name) {
+        *sorted_it = &buses_.back();
+    } else {
+        sorted_buses_.insert(sorted_it, &buses_.back());
+    }
+    for (const StopId stop : buses_.back().stops) {
+        vector<string_view>& buses = stop_to_buses_.at(stop);
+        const auto it = lower_bound(buses.begin(), buses.end(), bus_name);
+        if (it == buses.end() || *it != bus_name) {
+            buses.insert(it, bus_name);
+        }
+    }
+}
+
+
+void TransportCatalogue::ReserveStops(size_t stop_count) {
+    stop_ids_.reserve(stop_count);
+    stop_coordinates_.reserve(stop_count);
+    stop_to_buses_.reserve(stop_count);
 }
     
 void TransportCatalogue::SetDistance(const Stop* src, const Stop* dst, int64_t distance) {
-    stop_distances_[{src, dst}] = distance;
+    stop_distances_.Set(src->id, dst->id, distance);
 }
 
 Buses TransportCatalogue::GetBusesByStop(string_view stop_name) const {
-    if (GetStop(stop_name) == nullptr) { return {}; }
-    
-    vector<string_view> buses;
-    for_each (bus_names_to_ptrs_.begin(), bus_names_to_ptrs_.end(),
-            [stop_name, &buses](const auto bus_ptr) {
-                for (const auto stop : bus_ptr.second->stops) {
-                    if (stop->name == stop_name) {
-                        buses.push_back(bus_ptr.second->name);
-                        break;
-                    }
-                }
-            });
-    return buses;
+    const Stop* stop = GetStop(stop_name);
+    if (stop == nullptr) { return nullptr; }
+    return &stop_to_buses_[stop->id];
 }
 
 const Stop* TransportCatalogue::GetStop(std::string_view stop_name) const {
-    if (stop_names_to_ptrs_.count(stop_name) != 0) {
-        return stop_names_to_ptrs_.at(stop_name);
+    if (const auto it = stop_ids_.find(stop_name); it != stop_ids_.end()) {
+        return &stops_[it->second];
     } else {
         return nullptr;
     }
 }
 
+const Stop* TransportCatalogue::GetStopById(StopId id) const {
+    return &stops_[id];
+}
+
+geo::Coordinates TransportCatalogue::GetStopCoordinates(StopId id) const {
+    return stop_coordinates_[id];
+}
+
 const Bus* TransportCatalogue::GetBus(std::string_view bus_name) const {
-    if (bus_names_to_ptrs_.count(bus_name) != 0) {
-        return bus_names_to_ptrs_.at(bus_name);
+    if (const auto it = bus_ids_.find(bus_name); it != bus_ids_.end()) {
+        return &buses_[it->second];
     } else {
         return nullptr;
     }
 }
 
-int64_t TransportCatalogue::GetDistance(const Stop* src, const Stop* dst) const {
-    if (stop_distances_.count({src, dst}) != 0) {
-        return stop_distances_.at({src, dst});
-    } else {
-        return stop_distances_.at({dst, src});
+const Bus* TransportCatalogue::GetBusById(BusId id) const {
+    return &buses_[id];
+}
+
+std::optional<int64_t> TransportCatalogue::GetDistance(const Stop* src, const Stop* dst) const {
+    return GetDistance(src->id, dst->id);
+}
+
+std::optional<int64_t> TransportCatalogue::GetDistance(StopId src, StopId dst) const {
+    return stop_distances_.Get(src, dst);
+}
+
+int64_t TransportCatalogue::GetKnownDistance(StopId src, StopId dst) const {
+    if (const auto distance = stop_distances_.Get(src, dst)) {
+        return *distance;
     }
+    throw invalid_argument("Unknown distance between stops " + string(stops_[src].name) + " and " + string(stops_[dst].name));
 }
     
 BusStat TransportCatalogue::GetBusStat(const Bus* bus) const {
+    if (bus->id < bus_stats_.size()) {
+        return bus_stats_[bus->id];
+    }
+    return ComputeBusStat(bus);
+}
+
+void TransportCatalogue::ComputeBusStats(size_t thread_count) {
+    vector<BusStat> bus_stats(buses_.size());
+    parallel::ThreadPool pool(thread_count != 0 ? thread_count : parallel::GetDefaultThreadCount());
+    pool.ParallelFor(buses_.size(), [this, &bus_stats](size_t bus) {
+        bus_stats[bus] = ComputeBusStat(&buses_[bus]);
+    });
+    bus_stats_ = move(bus_stats);
+}
+
+void TransportCatalogue::SetBusStats(vector<BusStat> bus_stats) {
+    if (bus_stats.size() != buses_.size()) {
+        throw invalid_argument("Bus stats don't match the buses");
+    }
+    bus_stats_ = move(bus_stats);
+}
+    
+BusStat TransportCatalogue::ComputeBusStat(const Bus* bus) const {
     BusStat bus_stat;
     bus_stat.route_length = 0;
     bus_stat.real_route_length = 0;
-    vector<const Stop*> stops;
-    stops.insert(stops.begin(), bus->stops.begin(), bus->stops.end());
-    
-    if (!bus->is_roundtrip) {
-        for (int i = static_cast<int>(stops.size() - 2); i >= 0; --i) {
-            stops.push_back(stops[i]);
-        }
-    }
-    
-    unordered_set<const Stop*> unique_stops(stops.begin(), stops.end());
-    bus_stat.stops_count = static_cast<int>(stops.size());
+    // Остановки читаются прямо из общего массива: туда по порядку, а у некольцевого — и обратно
+    const BusStops& stops = bus->stops;
+    unordered_set<StopId> unique_stops(stops.begin(), stops.end());
+    bus_stat.stops_count = static_cast<int>(bus->is_roundtrip || stops.empty() ? stops.size() : 2 * stops.size() - 1);
     bus_stat.unique_stops_count = static_cast<int>(unique_stops.size());
     
-    for (size_t i = 0; i < (stops.size() - 1); ++i) {
-        bus_stat.route_length += ComputeDistance(stops[i]->coordinates, stops[i + 1]->coordinates);
-        bus_stat.real_route_length += GetDistance(stops[i], stops[i + 1]);
+    for (size_t i = 0; i + 1 < stops.size(); ++i) {
+        bus_stat.route_length += ComputeDistance(stop_coordinates_[stops[i]], stop_coordinates_[stops[i + 1]]);
+        bus_stat.real_route_length += GetKnownDistance(stops[i], stops[i + 1]);
+    }
+    if (!bus->is_roundtrip && !stops.empty()) {
+        for (size_t i = stops.size() - 1; i > 0; --i) {
+            bus_stat.route_length += ComputeDistance(stop_coordinates_[stops[i]], stop_coordinates_[stops[i - 1]]);
+            bus_stat.real_route_length += GetKnownDistance(stops[i], stops[i - 1]);
+        }
     }
     return bus_stat;
 }
 
-const std::map<std::string_view, const Bus*>& TransportCatalogue::GetAllBuses() const {
-    return bus_names_to_ptrs_;
+const std::vector<const Bus*>& TransportCatalogue::GetAllBuses() const {
+    return sorted_buses_;
 }
     
-const std::unordered_map<std::string_view, const Stop*>& TransportCatalogue::GetAllStops() const {
-    return stop_names_to_ptrs_;
-}
-    
-const std::unordered_map<std::pair<const Stop*, const Stop*>, int64_t, detail::PairHasher<const Stop*>> TransportCatalogue::GetAllDistances() const {
+const DistanceTable& TransportCatalogue::GetAllDistances() const {
     return stop_distances_;
 }    
     
 size_t TransportCatalogue::GetStopsCount() const {
     return stops_.size();
 }
+    
+size_t TransportCatalogue::GetBusesCount() const {
+    return buses_.size();
+}
 } // namespace catalogue
\ No newline at end of file
@@ -1,58 +1,97 @@
 #pragma once
+#include "distance_table.h"
 #include "domain.h"
 #include "geo.h"
+#include "string_arena.h"
+#include "thread_pool.h"
 
 #include <algorithm>
 #include <deque>
-#include <map>
+#include <stdexcept>
 #include <unordered_map>
 #include <unordered_set>
 
 namespace catalogue {
-namespace detail {
-    
-template <typename T>
-struct PairHasher {
-    std::hash<T> hasher;
-    
-    size_t operator()(const std::pair<T, T> pair_to_hash) const {
-        return hasher(pair_to_hash.first) + hasher(pair_to_hash.second) * 37;
-    }
-};
-} // namespace detail
     
 class TransportCatalogue {
 public:
+    // Название копируется в хранилище строк каталога
     void AddStop(const Stop& stop);
     
-    void AddBus(const Bus& bus);
+    // Название копируется в хранилище строк каталога, остановки — в общий массив остановок автобусов
+    void AddBus(std::string_view name, const std::vector<StopId>& stops, bool is_roundtrip);
+    
+    // Резервирует место под stop_count остановок, чтобы индексы не перестраивались при добавлении
+    void ReserveStops(size_t stop_count);
     
     void SetDistance(const Stop* src, const Stop* dst, int64_t distance);
     
     const Stop* GetStop(std::string_view stop_name) const;
     
+    // Номер не проверяется
+    const Stop* GetStopById(StopId id) const;
+    
+    // Координаты из плотного массива по номеру остановки; номер не проверяется
+    geo::Coordinates GetStopCoordinates(StopId id) const;
+    
     const Bus* GetBus(std::string_view bus_name) const;
     
+    // Номер не проверяется
+    const Bus* GetBusById(BusId id) const;
+    
+    // Список из индекса остановка — автобусы, без обхода всех автобусов
     Buses GetBusesByStop(std::string_view stop_name) const;
     
-    int64_t GetDistance(const Stop* src, const Stop* dst) const;
+    // Расстояние от src до dst, а если оно не задано — от dst до src; std::nullopt — расстояние неизвестно
+    std::optional<int64_t> GetDistance(const Stop* src, const Stop* dst) const;
+    
+    std::optional<int64_t> GetDistance(StopId src, StopId dst) const;
+    
+    // То же, но неизвестное расстояние — ошибка с названиями остановок
+    int64_t GetKnownDistance(StopId src, StopId dst) const;
     
+    // Статистика из таблицы, заполненной ComputeBusStats или SetBusStats; без неё считается на месте
     BusStat GetBusStat(const Bus* bus) const;
     
-    const std::map<std::string_view, const Bus*>& GetAllBuses() const;
+    // Считает статистику всех автобусов параллельно на thread_count потоках (0 — по числу аппаратных потоков).
+    // Если расстояние между соседними остановками какого-то автобуса неизвестно, выбрасывает std::invalid_argument
+    void ComputeBusStats(size_t thread_count);
     
-    const std::unordered_map<std::string_view, const Stop*>& GetAllStops() const;
+    // Статистика автобусов по их номерам, например из базы
+    void SetBusStats(std::vector<BusStat> bus_stats);
     
-    const std::unordered_map<std::pair<const Stop*, const Stop*>, int64_t, detail::PairHasher<const Stop*>> GetAllDistances() const;
+    // Автобусы по возрастанию названий
+    const std::vector<const Bus*>& GetAllBuses() const;
+    
+    const DistanceTable& GetAllDistances() const;
     
     size_t GetStopsCount() const;
     
+    size_t GetBusesCount() const;
+    
 private:
+    // Названия остановок и автобусов; на них ссылаются name в stops_ и buses_ и ключи индексов по названиям
+    StringArena names_;
     std::deque<Bus> buses_;
     std::deque<Stop> stops_;
-    std::map<std::string_view, const Bus*> bus_names_to_ptrs_;
-    std::unordered_map<std::string_view, const Stop*> stop_names_to_ptrs_;
-    std::unordered_map<std::pair<const Stop*, const Stop*>, int64_t, detail::PairHasher<const Stop*>> stop_distances_;
+    // Координаты остановок по номерам: расчёт длины маршрутов и эвристика A* читают только их
+    std::vector<geo::Coordinates> stop_coordinates_;
+    // Остановки всех автобусов подряд; остановки автобуса id — от bus_stop_offsets_[id] до bus_stop_offsets_[id + 1].
+    // Bus::stops указывает в этот массив и перенаправляется при его перераспределении
+    std::vector<StopId> bus_stops_;
+    std::vector<uint32_t> bus_stop_offsets_ = {0};
+    // Номера по названиям: поиск остановки или автобуса по названию хеширует его один раз
+    std::unordered_map<std::string_view, StopId> stop_ids_;
+    std::unordered_map<std::string_view, BusId> bus_ids_;
+    // Автобусы по возрастанию названий, пополняется при добавлении автобуса
+    std::vector<const Bus*> sorted_buses_;
+    DistanceTable stop_distances_;
+    // Автобусы каждой остановки по её номеру в порядке возрастания названий, пополняется при добавлении автобуса
+    std::vector<std::vector<std::string_view>> stop_to_buses_;
+    // Статистика автобусов по их номерам
+    std::vector<BusStat> bus_stats_;
+    
+    BusStat ComputeBusStat(const Bus* bus) const;
 };
 
 } // namespace catalogue
\ No newline at end of file
@@ -1,48 +1,305 @@
 #include "transport_router.h"
+#include "raptor_router.h"
+#include "route_cache.h"
 
 namespace catalogue {
 
 TransportRouter::TransportRouter(const TransportCatalogue& db)
     : db_(db) {}
     
+TransportRouter::~TransportRouter() = default;
+    
 void TransportRouter::BuildAllRoutes() {
+    if (router_mode_ == RouterMode::RAPTOR) {
+        raptor_router_ = std::make_unique<RaptorRouter>(db_, bus_wait_time_, bus_velocity_);
+        hub_labels_.reset();
+        ResetRouteCache();
+        return;
+    }
     route_graph_ = std::make_unique<graph::DirectedWeightedGraph<double>>(db_.GetStopsCount() * 2);
+    edge_items_.clear();
+    stop_to_vertexes_.clear();
     CreateCarcass();
-    for(const auto [bus_name, bus_ptr] : db_.GetAllBuses()) {
-        AddRouteToGraph(bus_name, bus_ptr);
+    for (const Bus* bus_ptr : db_.GetAllBuses()) {
+        AddRouteToGraph(bus_ptr);
+    }
+    FreezeGraph();
+    components_ = graph::ComputeGraphComponents(frozen_graph_);
+    BuildRouter();
+    BuildHubLabels();
+}
+
+void TransportRouter::RestoreGraph(graph::DirectedWeightedGraph<double> route_graph,
+                                   std::vector<Item> edge_items,
+                                   std::vector<std::pair<int, int>> stop_to_vertexes,
+                                   std::optional<graph::GraphComponents> components) {
+    route_graph_ = std::make_unique<graph::DirectedWeightedGraph<double>>(std::move(route_graph));
+    if (edge_items.size() != route_graph_->GetEdgeCount()) {
+        throw std::invalid_argument("Edge items don't match the route graph");
+    }
+    edge_items_ = std::move(edge_items);
+    stop_to_vertexes_ = std::move(stop_to_vertexes);
+    hub_labels_.reset();
+    FreezeGraph();
+    if (components && components->strong.size() == route_graph_->GetVertexCount()
+                   && components->weak.size() == route_graph_->GetVertexCount()) {
+        components_ = std::move(*components);
+    } else {
+        components_ = graph::ComputeGraphComponents(frozen_graph_);
+    }
+}
+    
+void TransportRouter::FreezeGraph() {
+    frozen_graph_ = graph::CsrGraph<double>(*route_graph_);
+    wait_vertex_stops_.assign(route_graph_->GetVertexCount(), nullptr);
+    for (StopId stop = 0; stop < stop_to_vertexes_.size(); ++stop) {
+        wait_vertex_stops_[stop_to_vertexes_[stop].first] = db_.GetStopById(stop);
+    }
+    edge_distances_.resize(edge_items_.size());
+    for (graph::EdgeId edge_id = 0; edge_id < edge_items_.size(); ++edge_id) {
+        edge_distances_[edge_id] = edge_items_[edge_id].distance;
+    }
+    closed_stops_.assign(stop_to_vertexes_.size(), false);
+    closed_stop_count_ = 0;
+    bus_time_factors_.assign(db_.GetBusesCount(), 1);
+    changed_bus_count_ = 0;
+    ApplyDisruptions();
+}
+    
+void TransportRouter::ApplyDisruptions() {
+    if (closed_stop_count_ == 0 && changed_bus_count_ == 0) {
+        live_weights_.clear();
+        edge_time_factors_.clear();
+        changed_edges_.clear();
+        changed_edge_count_ = 0;
+        precomputed_valid_ = true;
+        live_graph_ = {};
+        return;
+    }
+    const size_t edge_count = route_graph_->GetEdgeCount();
+    std::vector<bool> closed_wait_vertexes(route_graph_->GetVertexCount(), false);
+    for (StopId stop = 0; stop < closed_stops_.size(); ++stop) {
+        if (closed_stops_[stop]) {
+            closed_wait_vertexes[stop_to_vertexes_[stop].first] = true;
+        }
+    }
+    live_weights_.assign(edge_count, 0);
+    edge_time_factors_.assign(edge_count, 1);
+    changed_edges_.assign(edge_count, false);
+    changed_edge_count_ = 0;
+    precomputed_valid_ = true;
+    std::vector<graph::CsrGraph<double>::Arc> arcs;
+    arcs.reserve(edge_count);
+    for (graph::EdgeId edge_id = 0; edge_id < edge_count; ++edge_id) {
+        const Item& item = edge_items_[edge_id];
+        const auto& edge = route_graph_->GetEdge(edge_id);
+        double weight = edge.weight;
+        // Сесть на закрытой остановке — ребро ожидания из неё, сойти — ребро поездки в неё
+        if (closed_wait_vertexes[edge.from] || closed_wait_vertexes[edge.to]) {
+            weight = std::numeric_limits<double>::infinity();
+        } else if (item.type == ItemType::BUS && bus_time_factors_[item.id] != 1) {
+            const double factor = bus_time_factors_[item.id];
+            edge_time_factors_[edge_id] = factor;
+            // Выключенный автобус убирает ребро и при нулевом весе, где умножение дало бы NaN
+            weight = factor == std::numeric_limits<double>::infinity() ? factor : weight * factor;
+        }
+        live_weights_[edge_id] = weight;
+        if (weight != edge.weight) {
+            changed_edges_[edge_id] = true;
+            ++changed_edge_count_;
+            precomputed_valid_ = precomputed_valid_ && weight > edge.weight;
+        }
+        if (weight != std::numeric_limits<double>::infinity()) {
+            arcs.push_back({edge.from, edge.to, weight, edge_id});
+        }
+    }
+    live_graph_ = graph::CsrGraph<double>(route_graph_->GetVertexCount(), arcs);
+}
+    
+const graph::CsrGraph<double>& TransportRouter::GetSearchGraph() const {
+    return live_weights_.empty() ? frozen_graph_ : live_graph_;
+}
+    
+void TransportRouter::SetStopClosed(const Stop* stop, bool closed) {
+    if (raptor_router_) {
+        throw std::logic_error("Router updates are not supported in RAPTOR mode");
+    }
+    if (stop->id >= stop_to_vertexes_.size()) {
+        throw std::out_of_range("Stop is not in the route graph");
+    }
+    if (closed == closed_stops_[stop->id]) {
+        return;
+    }
+    closed_stops_[stop->id] = closed;
+    if (closed) {
+        ++closed_stop_count_;
+    } else {
+        --closed_stop_count_;
+    }
+    ApplyDisruptions();
+    if (!route_cache_) {
+        return;
+    }
+    // Открытие остановки может сократить любой маршрут
+    if (!closed) {
+        route_cache_->Clear();
+        return;
+    }
+    // Маршрут сходит с автобуса на остановке, только если ждёт на ней следующего или заканчивается на ней
+    route_cache_->EraseIf([stop](RouteCache::Key key, const RouteCache::Value& route) {
+        if (RouteCache::GetFrom(key) == stop->id || RouteCache::GetTo(key) == stop->id) {
+            return true;
+        }
+        return route && std::any_of(route->items.begin(), route->items.end(), [stop](const Item& item) {
+            return item.type == ItemType::WAIT && item.id == stop->id;
+        });
+    });
+}
+    
+void TransportRouter::SetBusTimeFactor(const Bus* bus, double time_factor) {
+    if (raptor_router_) {
+        throw std::logic_error("Router updates are not supported in RAPTOR mode");
+    }
+    if (!(time_factor > 0)) {
+        throw std::invalid_argument("Bus time factor should be positive");
+    }
+    if (bus->id >= bus_time_factors_.size()) {
+        throw std::out_of_range("Bus is not in the route graph");
+    }
+    const double previous_factor = bus_time_factors_[bus->id];
+    if (time_factor == previous_factor) {
+        return;
+    }
+    if (previous_factor == 1) {
+        ++changed_bus_count_;
+    } else if (time_factor == 1) {
+        --changed_bus_count_;
+    }
+    bus_time_factors_[bus->id] = time_factor;
+    ApplyDisruptions();
+    if (!route_cache_) {
+        return;
+    }
+    if (time_factor < previous_factor) {
+        route_cache_->Clear();
+        return;
+    }
+    // Если автобус замедлился, недостижимые пары остались недостижимыми, а остальные маршруты без него — кратчайшими
+    route_cache_->EraseIf([bus](RouteCache::Key, const RouteCache::Value& route) {
+        return route && std::any_of(route->items.begin(), route->items.end(), [bus](const Item& item) {
+            return item.type == ItemType::BUS && item.id == bus->id;
+        });
+    });
+}
+    
+size_t TransportRouter::GetChangedEdgeCount() const {
+    return changed_edge_count_;
+}
+
+void TransportRouter::BuildRouter() {
+    ResetRouteCache();
+    const size_t thread_count = thread_count_ != 0 ? thread_count_ : parallel::GetDefaultThreadCount();
+    if (router_mode_ == RouterMode::DIJKSTRA) {
+        graph_router_ = std::make_unique<graph::DijkstraRouter<double>>(*route_graph_, frozen_graph_);
+    } else if (router_mode_ == RouterMode::CONTRACTION_HIERARCHIES) {
+        graph_router_ = std::make_unique<graph::ContractionHierarchy<double>>(*route_graph_);
+    } else if (router_mode_ == RouterMode::A_STAR) {
+        graph_router_ = std::make_unique<graph::AStarRouter<double>>(*route_graph_, frozen_graph_,
+                                                                     MakeGeoHeuristic());
+    } else if (router_mode_ == RouterMode::STOP_PAIRS && compact_table_) {
+        graph_router_ = std::make_unique<graph::SubsetRouter<double, float>>(*route_graph_, GetWaitVertexes(), thread_count);
+    } else if (router_mode_ == RouterMode::STOP_PAIRS) {
+        graph_router_ = std::make_unique<graph::SubsetRouter<double>>(*route_graph_, GetWaitVertexes(), thread_count);
+    } else if (compact_table_) {
+        graph_router_ = std::make_unique<graph::Router<double, float>>(*route_graph_, thread_count);
+    } else {
+        graph_router_ = std::make_unique<graph::Router<double>>(*route_graph_, thread_count);
+    }
+}
+
+void TransportRouter::RestoreHierarchy(graph::ContractionHierarchy<double>::HierarchyData hierarchy_data) {
+    graph_router_ = std::make_unique<graph::ContractionHierarchy<double>>(*route_graph_, std::move(hierarchy_data));
+    ResetRouteCache();
+}
+    
+void TransportRouter::BuildHubLabels() {
+    if (!use_hub_labels_ || !route_graph_) {
+        hub_labels_.reset();
+        return;
+    }
+    if (const auto* hierarchy_data = GetHierarchyData()) {
+        hub_labels_ = std::make_unique<graph::HubLabels<double>>(*route_graph_, *hierarchy_data);
+    } else {
+        const graph::ContractionHierarchy<double> hierarchy(*route_graph_);
+        hub_labels_ = std::make_unique<graph::HubLabels<double>>(*route_graph_, hierarchy.GetHierarchyData());
+    }
+}
+    
+void TransportRouter::RestoreHubLabels(graph::HubLabels<double>::LabelsData labels_data) {
+    hub_labels_ = std::make_unique<graph::HubLabels<double>>(route_graph_->GetVertexCount(), std::move(labels_data));
+}
+    
+const graph::HubLabels<double>* TransportRouter::GetActiveHubLabels() const {
+    return live_weights_.empty() ? hub_labels_.get() : nullptr;
+}
+    
+void TransportRouter::ResetRouteCache() {
+    if (route_cache_) {
+        route_cache_->Clear();
     }
-    graph_router_ = std::make_unique<graph::Router<double>>(*route_graph_);
 }
     
 void TransportRouter::SetSettings(RouterSettings settings) {
     bus_wait_time_ = settings.time;
     bus_velocity_ = settings.velocity;
+    router_mode_ = settings.mode;
+    thread_count_ = settings.thread_count;
+    compact_table_ = settings.compact_table;
+    route_cache_size_ = settings.route_cache_size;
+    profiles_ = std::move(settings.profiles);
+    use_hub_labels_ = settings.hub_labels;
+    route_cache_ = route_cache_size_ != 0 ? std::make_unique<RouteCache>(route_cache_size_) : nullptr;
 }
 
 void TransportRouter::AddEdgeToItem(graph::VertexId start_vertex, graph::VertexId stop_vertex, Item item) {
-    edge_to_item_[route_graph_->AddEdge({start_vertex, stop_vertex, item.time})] = item;
+    route_graph_->AddEdge({start_vertex, stop_vertex, item.time});
+    edge_items_.push_back(item);
 }
 
-void TransportRouter::AddBusEdge(const Stop* start_stop, const Stop* finish_stop, std::string_view bus_name, int span, double distance) {
+void TransportRouter::AddBusEdge(StopId start_stop, StopId finish_stop, const Bus* bus, int span, double distance) {
     double coeff = 1000 / 60.0; // коэффициент перевода ЕИ скорости из км/ч в м/мин
     Item item;
     item.type = ItemType::BUS;
-    item.name = bus_name;
+    item.name = bus->name;
+    item.id = bus->id;
     item.time = distance / (bus_velocity_ * coeff);
     item.span_count = span;
-    AddEdgeToItem(GetStartBusVertex(start_stop), GetStartWaitVertex(finish_stop), item);
+    item.distance = distance;
+    AddEdgeToItem(stop_to_vertexes_[start_stop].second, stop_to_vertexes_[finish_stop].first, item);
 }
 
-void TransportRouter::AddRouteToGraph(const std::string_view bus_name, const Bus* bus_ptr) {
-    for (int i = 0; i < bus_ptr->stops.size() - 1; ++i) {
+void TransportRouter::AddRouteToGraph(const Bus* bus_ptr) {
+    // Расстояния между соседними остановками запрашиваются один раз, а не для каждой пары остановок маршрута
+    std::vector<int64_t> forward_segments;
+    std::vector<int64_t> backward_segments;
+    forward_segments.reserve(bus_ptr->stops.size());
+    backward_segments.reserve(bus_ptr->stops.size());
+    for (size_t j = 0; j + 1 < bus_ptr->stops.size(); ++j) {
+        forward_segments.push_back(db_.GetKnownDistance(bus_ptr->stops[j], bus_ptr->stops[j + 1]));
+        if (!bus_ptr->is_roundtrip) {
+            backward_segments.push_back(db_.GetKnownDistance(bus_ptr->stops[j + 1], bus_ptr->stops[j]));
+        }
+    }
+    for (size_t i = 0; i + 1 < bus_ptr->stops.size(); ++i) {
         double forward_distance = 0;
         double backward_distance = 0;
-        for (int j = i; j < bus_ptr->stops.size() - 1; ++j) {
-            forward_distance += db_.GetDistance(bus_ptr->stops[j], bus_ptr->stops[j + 1]);
-            AddBusEdge(bus_ptr->stops[i], bus_ptr->stops[j + 1], bus_name, j - i + 1, forward_distance);
+        for (size_t j = i; j + 1 < bus_ptr->stops.size(); ++j) {
+            const int span = static_cast<int>(j - i + 1);
+            forward_distance += forward_segments[j];
+            AddBusEdge(bus_ptr->stops[i], bus_ptr->stops[j + 1], bus_ptr, span, forward_distance);
             if (!bus_ptr->is_roundtrip){
-                backward_distance += db_.GetDistance(bus_ptr->stops[j + 1], bus_ptr->stops[j]);
-                AddBusEdge(bus_ptr->stops[j + 1], bus_ptr->stops[i], bus_name, j - i + 1, backward_distance);
+                backward_distance += backward_segments[j];
+                AddBusEdge(bus_ptr->stops[j + 1], bus_ptr->stops[i], bus_ptr, span, backward_distance);
             }
         }
     }
@@ -50,40 +307,393 @@ void TransportRouter::AddRouteToGraph(const std::string_view bus_name, const Bus
 
 void TransportRouter::CreateCarcass() {
     graph::VertexId vertex_id = 0;
-    for (const auto& [stop_name, stop_ptr] : db_.GetAllStops()) {
-        stop_to_vertexes_[stop_ptr] = {vertex_id, vertex_id + 1};
-        edge_to_item_[route_graph_->AddEdge({vertex_id, vertex_id + 1, static_cast<double>(bus_wait_time_)})] = {ItemType::WAIT,
-                                                                                                                stop_name,
-                                                                                                                static_cast<double>(bus_wait_time_),
-                                                                                                                1};
+    stop_to_vertexes_.reserve(db_.GetStopsCount());
+    for (StopId stop = 0; stop < db_.GetStopsCount(); ++stop) {
+        stop_to_vertexes_.push_back({vertex_id, vertex_id + 1});
+        AddEdgeToItem(vertex_id, vertex_id + 1, {ItemType::WAIT, db_.GetStopById(stop)->name,
+                                                 static_cast<double>(bus_wait_time_), 1, stop});
         vertex_id += 2;
     }
 }
 
-std::optional<RouteItems> TransportRouter::GetRoute(const Stop* start_stop, const Stop* finish_stop) const {
+std::optional<RouteItems> TransportRouter::GetRoute(const Stop* start_stop, const Stop* finish_stop,
+                                                    graph::SearchStats* stats) const {
+    RouteBuffer buffer;
+    const std::optional<double> total_time = GetRoute(start_stop, finish_stop, buffer, stats);
+    if (!total_time) {
+        return std::nullopt;
+    }
+    return RouteItems{*total_time, std::move(buffer.items)};
+}
+    
+std::optional<double> TransportRouter::GetRoute(const Stop* start_stop, const Stop* finish_stop, RouteBuffer& buffer,
+                                                graph::SearchStats* stats) const {
+    if (!route_cache_) {
+        return FindRoute(start_stop, finish_stop, buffer, stats);
+    }
+    const RouteCache::Key key = RouteCache::MakeKey(start_stop->id, finish_stop->id);
+    if (const std::optional<std::optional<double>> cached_time = route_cache_->Get(key, buffer.items)) {
+        if (stats != nullptr) {
+            *stats = {};
+        }
+        return *cached_time;
+    }
+    const std::optional<double> total_time = FindRoute(start_stop, finish_stop, buffer, stats);
+    route_cache_->Put(key, total_time ? RouteCache::Value(RouteItems{*total_time, buffer.items}) : std::nullopt);
+    return total_time;
+}
+    
+std::optional<double> TransportRouter::FindRoute(const Stop* start_stop, const Stop* finish_stop, RouteBuffer& buffer,
+                                                 graph::SearchStats* stats) const {
+    buffer.items.clear();
+    if (raptor_router_) {
+        return CopyRaptorRoute(raptor_router_->GetRoute(start_stop, finish_stop, stats), buffer);
+    }
+    const graph::VertexId start_vertex = GetStartWaitVertex(start_stop);
+    const graph::VertexId finish_vertex = GetStartWaitVertex(finish_stop);
+    if (components_.IsUnreachable(start_vertex, finish_vertex)) {
+        if (stats != nullptr) {
+            *stats = {};
+        }
+        return std::nullopt;
+    }
+    if (!live_weights_.empty()) {
+        return FindDisruptedRoute(start_vertex, finish_vertex, buffer, stats);
+    }
+    // Метки отвечают точно, поэтому недостижимость по ним не требует поиска, а время берётся из них
+    std::optional<double> total_time;
+    if (const graph::HubLabels<double>* hub_labels = GetActiveHubLabels()) {
+        total_time = hub_labels->GetWeight(start_vertex, finish_vertex);
+        if (!total_time) {
+            if (stats != nullptr) {
+                *stats = {};
+            }
+            return std::nullopt;
+        }
+    }
+    const std::optional<double> weight = graph_router_->BuildRouteEdges(start_vertex, finish_vertex, buffer.edges, stats);
+    if (!weight) {
+        return std::nullopt;
+    }
+    for (const graph::EdgeId edge_id : buffer.edges) {
+        buffer.items.push_back(edge_items_[edge_id]);
+    }
+    return total_time ? total_time : weight;
+}
+    
+std::optional<double> TransportRouter::FindDisruptedRoute(graph::VertexId start_vertex, graph::VertexId finish_vertex,
+                                                          RouteBuffer& buffer, graph::SearchStats* stats) const {
+    graph::SearchStats search_stats;
+    std::optional<double> weight;
+    bool repaired = false;
+    if (precomputed_valid_) {
+        weight = graph_router_->BuildRouteEdges(start_vertex, finish_vertex, buffer.edges, &search_stats);
+        repaired = weight && std::any_of(buffer.edges.begin(), buffer.edges.end(),
+                                         [this](graph::EdgeId edge_id) { return changed_edges_[edge_id]; });
+    }
+    if (!precomputed_valid_ || repaired) {
+        const auto router_info = graph::FindShortestPath(live_graph_, start_vertex, finish_vertex,
+                                                         [this](graph::VertexId, size_t arc) { return live_graph_.GetWeight(arc); },
+                                                         search_stats);
+        weight.reset();
+        buffer.edges.clear();
+        if (router_info) {
+            weight = router_info->weight;
+            buffer.edges.insert(buffer.edges.end(), router_info->edges.begin(), router_info->edges.end());
+        }
+    }
+    if (stats != nullptr) {
+        *stats = search_stats;
+    }
+    if (!weight) {
+        return std::nullopt;
+    }
+    for (const graph::EdgeId edge_id : buffer.edges) {
+        buffer.items.push_back(edge_items_[edge_id]);
+        buffer.items.back().time = live_weights_[edge_id];
+    }
+    return weight;
+}
+    
+std::optional<double> TransportRouter::CopyRaptorRoute(std::optional<RouteItems> route, RouteBuffer& buffer) {
+    if (!route) {
+        return std::nullopt;
+    }
+    buffer.items.insert(buffer.items.end(), route->items.begin(), route->items.end());
+    return route->total_time;
+}
+    
+RouteItems TransportRouter::MakeRouteItems(const graph::RoutingEngine<double>::RouteInfo& router_info) const {
     RouteItems items_info;
-    std::optional<graph::Router<double>::RouteInfo> router_info = graph_router_->BuildRoute(GetStartWaitVertex(start_stop), GetStartWaitVertex(finish_stop));
-    if (router_info) {
-        items_info.total_time = router_info.value().weight;
-        for (const auto& edge : router_info.value().edges) {
-            items_info.items.push_back(edge_to_item_.at(edge));
+    items_info.total_time = router_info.weight;
+    items_info.items.reserve(router_info.edges.size());
+    for (const auto& edge : router_info.edges) {
+        items_info.items.push_back(edge_items_[edge]);
+    }
+    return items_info;
+}
+    
+std::optional<RouteItems> TransportRouter::GetRoute(const Stop* start_stop, const Stop* finish_stop,
+                                                    const RoutingProfile& profile, graph::SearchStats* stats) const {
+    RouteBuffer buffer;
+    const std::optional<double> total_time = GetRoute(start_stop, finish_stop, profile, buffer, stats);
+    if (!total_time) {
+        return std::nullopt;
+    }
+    return RouteItems{*total_time, std::move(buffer.items)};
+}
+    
+std::optional<double> TransportRouter::GetRoute(const Stop* start_stop, const Stop* finish_stop,
+                                                const RoutingProfile& profile, RouteBuffer& buffer,
+                                                graph::SearchStats* stats) const {
+    buffer.items.clear();
+    if (raptor_router_) {
+        return CopyRaptorRoute(raptor_router_->GetRoute(start_stop, finish_stop, profile, stats), buffer);
+    }
+    const double velocity = profile.velocity * (1000 / 60.0); // скорость в м/мин
+    graph::SearchStats search_stats;
+    const graph::VertexId start_vertex = GetStartWaitVertex(start_stop);
+    const graph::VertexId finish_vertex = GetStartWaitVertex(finish_stop);
+    std::optional<graph::RoutingEngine<double>::RouteInfo> router_info;
+    if (!components_.IsUnreachable(start_vertex, finish_vertex)) {
+        // Из вершины ожидания выходит только ребро ожидания
+        // Из графа с текущими весами выключенные рёбра уже удалены, замедление учитывается множителем
+        const graph::CsrGraph<double>& search_graph = GetSearchGraph();
+        router_info = graph::FindShortestPath(search_graph, start_vertex, finish_vertex,
+                                              [this, &profile, &search_graph, velocity](graph::VertexId vertex, size_t arc) {
+                                                  if (wait_vertex_stops_[vertex] != nullptr) {
+                                                      return profile.time;
+                                                  }
+                                                  const graph::EdgeId edge_id = search_graph.GetEdgeId(arc);
+                                                  const double time = edge_distances_[edge_id] / velocity;
+                                                  return edge_time_factors_.empty() ? time : time * edge_time_factors_[edge_id];
+                                              },
+                                              search_stats);
+    }
+    if (stats != nullptr) {
+        *stats = search_stats;
+    }
+    if (!router_info) {
+        return std::nullopt;
+    }
+    for (const auto& edge : router_info->edges) {
+        Item item = edge_items_[edge];
+        item.time = item.type == ItemType::WAIT ? profile.time : item.distance / velocity;
+        if (item.type == ItemType::BUS && !edge_time_factors_.empty()) {
+            item.time *= edge_time_factors_[edge];
         }
-        return items_info;
-    } else {
-        return {};
+        buffer.items.push_back(item);
+    }
+    return router_info->weight;
+}
+    
+const RoutingProfile* TransportRouter::FindProfile(std::string_view name) const {
+    const auto it = profiles_.find(name);
+    return it != profiles_.end() ? &it->second : nullptr;
+}
+    
+std::optional<double> TransportRouter::GetRouteTime(const Stop* start_stop, const Stop* finish_stop) const {
+    if (const graph::HubLabels<double>* hub_labels = GetActiveHubLabels()) {
+        return hub_labels->GetWeight(GetStartWaitVertex(start_stop), GetStartWaitVertex(finish_stop));
+    }
+    if (const std::optional<RouteItems> route = GetRoute(start_stop, finish_stop)) {
+        return route->total_time;
+    }
+    return std::nullopt;
+}
+    
+std::vector<std::optional<RouteItems>> TransportRouter::GetRoutesFrom(const Stop* start_stop,
+                                                                      const std::vector<const Stop*>& finish_stops,
+                                                                      bool with_items) const {
+    if (raptor_router_) {
+        return raptor_router_->GetRoutesFrom(start_stop, finish_stops, with_items);
+    }
+    if (!live_weights_.empty()) {
+        std::vector<std::optional<RouteItems>> routes;
+        routes.reserve(finish_stops.size());
+        RouteBuffer buffer;
+        for (const Stop* finish_stop : finish_stops) {
+            const std::optional<double> total_time = FindRoute(start_stop, finish_stop, buffer, nullptr);
+            if (!total_time) {
+                routes.emplace_back();
+            } else if (with_items) {
+                routes.push_back(RouteItems{*total_time, buffer.items});
+            } else {
+                routes.push_back(RouteItems{*total_time, {}});
+            }
+        }
+        return routes;
+    }
+    const graph::VertexId start_vertex = GetStartWaitVertex(start_stop);
+    if (const graph::HubLabels<double>* hub_labels = GetActiveHubLabels(); hub_labels != nullptr && !with_items) {
+        std::vector<std::optional<RouteItems>> routes(finish_stops.size());
+        for (size_t i = 0; i < finish_stops.size(); ++i) {
+            if (const auto total_time = hub_labels->GetWeight(start_vertex, GetStartWaitVertex(finish_stops[i]))) {
+                routes[i] = RouteItems{*total_time, {}};
+            }
+        }
+        return routes;
+    }
+    // Заведомо недостижимые остановки в поиск не передаются: поиск по графу ждал бы их до исчерпания
+    std::vector<graph::VertexId> finish_vertexes;
+    std::vector<size_t> finish_indexes;
+    for (size_t i = 0; i < finish_stops.size(); ++i) {
+        const graph::VertexId finish_vertex = GetStartWaitVertex(finish_stops[i]);
+        if (!components_.IsUnreachable(start_vertex, finish_vertex)) {
+            finish_vertexes.push_back(finish_vertex);
+            finish_indexes.push_back(i);
+        }
+    }
+    std::vector<std::optional<RouteItems>> routes(finish_stops.size());
+    auto router_infos = graph_router_->BuildRoutesFrom(start_vertex, finish_vertexes, with_items);
+    for (size_t i = 0; i < router_infos.size(); ++i) {
+        if (!router_infos[i]) {
+            continue;
+        }
+        routes[finish_indexes[i]] = MakeRouteItems(*router_infos[i]);
     }
+    return routes;
+}
+    
+std::vector<std::vector<std::optional<RouteItems>>> TransportRouter::GetRouteMatrix(
+        const std::vector<const Stop*>& start_stops, const std::vector<const Stop*>& finish_stops, bool with_items) const {
+    // Времена без маршрутов иерархия сжатия считает для всей матрицы корзинным поиском;
+    // в остальных случаях каждая строка — один поиск из остановки отправления
+    const auto* hierarchy = dynamic_cast<const graph::ContractionHierarchy<double>*>(graph_router_.get());
+    if (hierarchy == nullptr || with_items || !live_weights_.empty() || GetActiveHubLabels() != nullptr) {
+        std::vector<std::vector<std::optional<RouteItems>>> matrix;
+        matrix.reserve(start_stops.size());
+        for (const Stop* start_stop : start_stops) {
+            matrix.push_back(GetRoutesFrom(start_stop, finish_stops, with_items));
+        }
+        return matrix;
+    }
+    const auto get_vertexes = [this](const std::vector<const Stop*>& stops) {
+        std::vector<graph::VertexId> vertexes;
+        vertexes.reserve(stops.size());
+        for (const Stop* stop : stops) {
+            vertexes.push_back(GetStartWaitVertex(stop));
+        }
+        return vertexes;
+    };
+    const auto weights = hierarchy->BuildWeightMatrix(get_vertexes(start_stops), get_vertexes(finish_stops));
+    std::vector<std::vector<std::optional<RouteItems>>> matrix(start_stops.size(),
+                                                               std::vector<std::optional<RouteItems>>(finish_stops.size()));
+    for (size_t i = 0; i < start_stops.size(); ++i) {
+        for (size_t j = 0; j < finish_stops.size(); ++j) {
+            if (weights[i][j]) {
+                matrix[i][j] = RouteItems{*weights[i][j], {}};
+            }
+        }
+    }
+    return matrix;
+}
+    
+std::vector<std::pair<const Stop*, double>> TransportRouter::GetReachableStops(const Stop* start_stop, double max_time) const {
+    if (raptor_router_) {
+        return raptor_router_->GetReachableStops(start_stop, max_time);
+    }
+    std::vector<std::pair<const Stop*, double>> reachable_stops;
+    for (const auto& [vertex, time] : graph::FindReachableVertices(GetSearchGraph(), GetStartWaitVertex(start_stop), max_time)) {
+        if (wait_vertex_stops_[vertex] != nullptr) {
+            reachable_stops.push_back({wait_vertex_stops_[vertex], time});
+        }
+    }
+    return reachable_stops;
 }
     
 RouterSettings TransportRouter::GetSettings() const {
-    return {bus_wait_time_, bus_velocity_};
+    return {bus_wait_time_, bus_velocity_, router_mode_, thread_count_, compact_table_, route_cache_size_, profiles_,
+            use_hub_labels_};
+}
+    
+std::optional<RouteCacheStats> TransportRouter::GetRouteCacheStats() const {
+    if (!route_cache_) {
+        return std::nullopt;
+    }
+    return route_cache_->GetStats();
+}
+    
+bool TransportRouter::HasGraph() const {
+    return route_graph_ != nullptr;
+}
+    
+const graph::DirectedWeightedGraph<double>& TransportRouter::GetGraph() const {
+    return *route_graph_;
+}
+    
+const std::vector<Item>& TransportRouter::GetEdgeItems() const {
+    return edge_items_;
+}
+    
+const std::vector<std::pair<int, int>>& TransportRouter::GetStopVertexes() const {
+    return stop_to_vertexes_;
+}
+    
+const graph::GraphComponents& TransportRouter::GetComponents() const {
+    return components_;
+}
+    
+const graph::ContractionHierarchy<double>::HierarchyData* TransportRouter::GetHierarchyData() const {
+    if (const auto* hierarchy = dynamic_cast<const graph::ContractionHierarchy<double>*>(graph_router_.get())) {
+        return &hierarchy->GetHierarchyData();
+    }
+    return nullptr;
+}
+    
+const graph::HubLabels<double>::LabelsData* TransportRouter::GetHubLabelsData() const {
+    return hub_labels_ ? &hub_labels_->GetLabelsData() : nullptr;
 }
     
 graph::VertexId TransportRouter::GetStartWaitVertex(const Stop* stop_ptr) const {
-    return stop_to_vertexes_.at(stop_ptr).first;
+    if (stop_ptr == nullptr) {
+        throw std::invalid_argument("Stop is not in the catalogue");
+    }
+    return stop_to_vertexes_.at(stop_ptr->id).first;
 }
-
-graph::VertexId TransportRouter::GetStartBusVertex(const Stop* stop_ptr) const {
-    return stop_to_vertexes_.at(stop_ptr).second;
+    
+std::vector<graph::VertexId> TransportRouter::GetWaitVertexes() const {
+    std::vector<graph::VertexId> wait_vertexes;
+    wait_vertexes.reserve(stop_to_vertexes_.size());
+    for (const auto& vertexes : stop_to_vertexes_) {
+        wait_vertexes.push_back(vertexes.first);
+    }
+    std::sort(wait_vertexes.begin(), wait_vertexes.end());
+    return wait_vertexes;
+}
+    
+graph::AStarRouter<double>::Heuristic TransportRouter::MakeGeoHeuristic() const {
+    std::vector<geo::Coordinates> coordinates(route_graph_->GetVertexCount());
+    std::vector<bool> is_wait_vertex(route_graph_->GetVertexCount(), false);
+    for (StopId stop = 0; stop < stop_to_vertexes_.size(); ++stop) {
+        const auto& [wait_vertex, bus_vertex] = stop_to_vertexes_[stop];
+        coordinates[wait_vertex] = coordinates[bus_vertex] = db_.GetStopCoordinates(stop);
+        is_wait_vertex[wait_vertex] = true;
+    }
+    // Наименьшее время на метр расстояния по прямой среди рёбер графа. По неравенству треугольника
+    // время до цели не меньше этой величины, умноженной на расстояние до цели по прямой, даже если
+    // дорожное расстояние где-то задано короче прямого
+    double time_per_meter = std::numeric_limits<double>::infinity();
+    for (graph::EdgeId edge_id = 0; edge_id < route_graph_->GetEdgeCount(); ++edge_id) {
+        const auto& edge = route_graph_->GetEdge(edge_id);
+        const double distance = geo::ComputeDistance(coordinates[edge.from], coordinates[edge.to]);
+        if (distance > 0) {
+            time_per_meter = std::min(time_per_meter, edge.weight / distance);
+        }
+    }
+    if (time_per_meter == std::numeric_limits<double>::infinity()) {
+        time_per_meter = 0;
+    }
+    // Запас на погрешность вычисления расстояний, чтобы оценка оставалась допустимой
+    time_per_meter *= 1 - 1e-9;
+    // Из вершины ожидания выходит только ребро ожидания, поэтому путь из неё в другую вершину
+    // начинается с ожидания автобуса
+    const double wait_time = bus_wait_time_;
+    return [coordinates = std::move(coordinates), is_wait_vertex = std::move(is_wait_vertex), time_per_meter, wait_time](
+               graph::VertexId vertex, graph::VertexId to) {
+        const double ride_time = time_per_meter * geo::ComputeDistance(coordinates[vertex], coordinates[to]);
+        return is_wait_vertex[vertex] && vertex != to ? wait_time + ride_time : ride_time;
+    };
 }
     
 } // namespace catalogue
\ No newline at end of file
@@ -1,7 +1,14 @@
 #pragma once
 #include "transport_catalogue.h"
+#include "a_star_router.h"
+#include "contraction_hierarchy.h"
+#include "dijkstra_router.h"
+#include "graph_components.h"
+#include "hub_labels.h"
 #include "router.h"
+#include "subset_router.h"
 
+#include <map>
 #include <memory>
 
 namespace catalogue {
@@ -16,6 +23,9 @@ struct Item {
     std::string_view name;
     double time;
     int span_count;
+    // Номер остановки ожидания или автобуса поездки в каталоге
+    uint32_t id = 0;
+    double distance = 0; // для поездки — расстояние в метрах, по нему время пересчитывается для других профилей
 };
 
 struct RouteItems {
@@ -23,42 +33,266 @@ struct RouteItems {
     std::vector<Item> items;
 };
 
+// Переиспользуемый буфер маршрута: при повторных запросах с одним буфером его ёмкости хватает,
+// и маршрут восстанавливается без выделения памяти
+struct RouteBuffer {
+    std::vector<graph::EdgeId> edges;
+    std::vector<Item> items;
+};
+
+enum class RouterMode {
+    ALL_PAIRS,
+    DIJKSTRA,
+    STOP_PAIRS,
+    CONTRACTION_HIERARCHIES,
+    A_STAR,
+    RAPTOR
+    };
+
+// Профиль маршрутизации: время ожидания автобуса в минутах и его скорость в км/ч
+struct RoutingProfile {
+    double time;
+    double velocity;
+};
+
 struct RouterSettings {
     int time;
     double velocity;
+    RouterMode mode = RouterMode::ALL_PAIRS;
+    size_t thread_count = 1; // по умолчанию в одном потоке, 0 — по числу аппаратных потоков
+    bool compact_table = false; // хранить веса таблицы маршрутов во float
+    size_t route_cache_size = 0; // ёмкость кэша маршрутов в байтах, 0 — без кэша
+    std::map<std::string, RoutingProfile, std::less<>> profiles; // именованные профили кроме основного
+    bool hub_labels = false; // строить индекс меток-хабов для запросов времени в пути
+};
+    
+struct RouteCacheStats {
+    size_t hits;
+    size_t misses;
+    size_t evictions;
+    // Оценка памяти, занятой записями кэша
+    size_t size_bytes;
 };
     
+class RaptorRouter;
+class RouteCache;
+    
 class TransportRouter {
 public:
     TransportRouter(const TransportCatalogue& db);
     
+    ~TransportRouter();
+    
+    // В режиме RAPTOR граф маршрутов не строится, маршруты ищутся по последовательностям остановок автобусов
     void BuildAllRoutes();
     
+    // Восстанавливает граф маршрутов, сохранённый в базе. Если компоненты связности
+    // в базе не сохранены, вычисляет их заново
+    void RestoreGraph(graph::DirectedWeightedGraph<double> route_graph,
+                      std::vector<Item> edge_items,
+                      std::vector<std::pair<int, int>> stop_to_vertexes,
+                      std::optional<graph::GraphComponents> components = std::nullopt);
+    
+    // Создаёт движок маршрутизации по готовому графу; в режимах ALL_PAIRS и STOP_PAIRS вычисляет таблицу маршрутов
+    void BuildRouter();
+    
+    // Создаёт табличный движок текущего режима по таблице маршрутов, сохранённой в базе
+    template <typename TableWeight>
+    void RestoreRouter(graph::RoutesTable<TableWeight> routes_table);
+    
+    // Создаёт движок CONTRACTION_HIERARCHIES по иерархии, сохранённой в базе
+    void RestoreHierarchy(graph::ContractionHierarchy<double>::HierarchyData hierarchy_data);
+    
+    // Строит индекс меток-хабов по порядку иерархии сжатия, если он включён в настройках. В режиме
+    // CONTRACTION_HIERARCHIES берёт иерархию движка, в остальных строит временную
+    void BuildHubLabels();
+    
+    // Восстанавливает индекс меток-хабов, сохранённый в базе
+    void RestoreHubLabels(graph::HubLabels<double>::LabelsData labels_data);
+    
     void SetSettings(RouterSettings settings);
     
-    std::optional<RouteItems> GetRoute(const Stop* start_stop, const Stop* finish_stop) const;
+    // Если передан stats, заполняет его статистикой поиска по графу; при попадании в кэш маршрутов она нулевая
+    std::optional<RouteItems> GetRoute(const Stop* start_stop, const Stop* finish_stop,
+                                       graph::SearchStats* stats = nullptr) const;
+    
+    // Маршрут в buffer.items, возвращает время в пути. Маршрут всегда восстанавливается прямо в буфер,
+    // выделяют память только рабочие массивы поиска по графу, RAPTOR и запись кэша при промахе
+    std::optional<double> GetRoute(const Stop* start_stop, const Stop* finish_stop, RouteBuffer& buffer,
+                                   graph::SearchStats* stats = nullptr) const;
+    
+    // Маршрут по профилю, отличному от основного: веса рёбер вычисляются во время поиска по расстояниям,
+    // поэтому для профиля не нужен ни отдельный граф, ни предвычисленные данные. Кэш маршрутов не используется
+    std::optional<RouteItems> GetRoute(const Stop* start_stop, const Stop* finish_stop, const RoutingProfile& profile,
+                                       graph::SearchStats* stats = nullptr) const;
+    
+    // Маршрут по профилю в buffer.items, возвращает время в пути
+    std::optional<double> GetRoute(const Stop* start_stop, const Stop* finish_stop, const RoutingProfile& profile,
+                                   RouteBuffer& buffer, graph::SearchStats* stats = nullptr) const;
+    
+    // Именованный профиль из настроек, nullptr — такого нет
+    const RoutingProfile* FindProfile(std::string_view name) const;
+    
+    // Время в пути без самого маршрута. С индексом меток-хабов — слияние двух меток без поиска по графу,
+    // без него или при оперативных изменениях — время маршрута, найденного движком
+    std::optional<double> GetRouteTime(const Stop* start_stop, const Stop* finish_stop) const;
+    
+    // Оперативные изменения загруженного маршрутизатора без перестроения. На закрытой остановке нельзя
+    // сесть в автобус и сойти с него. time_factor — во сколько раз дольше обычного едет автобус,
+    // бесконечность выключает его рейсы. Предвычисленные маршруты, не проходящие по изменённым рёбрам,
+    // используются, пока веса только растут, остальные ищутся по графу с текущими весами.
+    // Из кэша удаляются только маршруты, затронутые изменением. В режиме RAPTOR не поддерживаются
+    void SetStopClosed(const Stop* stop, bool closed);
+    
+    void SetBusTimeFactor(const Bus* bus, double time_factor);
+    
+    // Число рёбер, вес которых сейчас отличается от исходного
+    size_t GetChangedEdgeCount() const;
+    
+    // Маршруты из start_stop в каждую из finish_stops; без with_items у маршрутов заполняется только total_time
+    std::vector<std::optional<RouteItems>> GetRoutesFrom(const Stop* start_stop,
+                                                         const std::vector<const Stop*>& finish_stops,
+                                                         bool with_items) const;
+    
+    // Маршруты из каждой из start_stops в каждую из finish_stops, по строке на остановку отправления
+    std::vector<std::vector<std::optional<RouteItems>>> GetRouteMatrix(const std::vector<const Stop*>& start_stops,
+                                                                       const std::vector<const Stop*>& finish_stops,
+                                                                       bool with_items) const;
+    
+    // Остановки, до которых можно добраться из start_stop не дольше чем за max_time, со временем в пути
+    // в порядке его возрастания
+    std::vector<std::pair<const Stop*, double>> GetReachableStops(const Stop* start_stop, double max_time) const;
     
     RouterSettings GetSettings() const;
     
+    // Счётчики кэша маршрутов, если он включён
+    std::optional<RouteCacheStats> GetRouteCacheStats() const;
+    
+    bool HasGraph() const;
+    
+    const graph::DirectedWeightedGraph<double>& GetGraph() const;
+    
+    // Элемент маршрута каждого ребра по его номеру
+    const std::vector<Item>& GetEdgeItems() const;
+    
+    // Вершины ожидания и посадки каждой остановки по её номеру
+    const std::vector<std::pair<int, int>>& GetStopVertexes() const;
+    
+    // Компоненты связности графа маршрутов для быстрого ответа на запросы между недостижимыми остановками
+    const graph::GraphComponents& GetComponents() const;
+    
+    // Таблица маршрутов между всеми парами вершин, если движок хранит её с весами TableWeight
+    template <typename TableWeight>
+    const graph::RoutesTable<TableWeight>* GetRoutesTable() const;
+    
+    // Иерархия сжатия, если движок построен в режиме CONTRACTION_HIERARCHIES
+    const graph::ContractionHierarchy<double>::HierarchyData* GetHierarchyData() const;
+    
+    // Метки-хабы, если индекс построен
+    const graph::HubLabels<double>::LabelsData* GetHubLabelsData() const;
+    
 private:
-    void AddRouteToGraph(const std::string_view bus_name, const Bus* bus_ptr);
+    // Ищет маршрут в обход кэша и записывает его в buffer.items
+    std::optional<double> FindRoute(const Stop* start_stop, const Stop* finish_stop, RouteBuffer& buffer,
+                                    graph::SearchStats* stats) const;
+    
+    // Сбрасывает кэш маршрутов после замены движка маршрутизации
+    void ResetRouteCache();
+    
+    void AddRouteToGraph(const Bus* bus_ptr);
     
     void CreateCarcass();
     
     void AddEdgeToItem(graph::VertexId start_vertex, graph::VertexId stop_vertex, Item item);
     
-    void AddBusEdge(const Stop* start_stop, const Stop* finish_stop, std::string_view bus_name, int span, double distance);
+    void AddBusEdge(StopId start_stop, StopId finish_stop, const Bus* bus, int span, double distance);
     
     graph::VertexId GetStartWaitVertex(const Stop* stop_ptr) const;
     
-    graph::VertexId GetStartBusVertex(const Stop* stop_ptr) const;
+    // Вершины ожидания всех остановок по возрастанию
+    std::vector<graph::VertexId> GetWaitVertexes() const;
+    
+    // Неизменяемая копия графа для поиска по нему вне движка маршрутизации; сбрасывает оперативные изменения
+    void FreezeGraph();
+    
+    // Пересчитывает текущие веса рёбер и граф для поиска по ним после оперативного изменения
+    void ApplyDisruptions();
+    
+    // Граф с текущими весами, если есть оперативные изменения, иначе исходный
+    const graph::CsrGraph<double>& GetSearchGraph() const;
+    
+    std::optional<double> FindDisruptedRoute(graph::VertexId start_vertex, graph::VertexId finish_vertex,
+                                             RouteBuffer& buffer, graph::SearchStats* stats) const;
+    
+    // Дописывает маршрут RAPTOR в buffer.items
+    static std::optional<double> CopyRaptorRoute(std::optional<RouteItems> route, RouteBuffer& buffer);
+    
+    RouteItems MakeRouteItems(const graph::RoutingEngine<double>::RouteInfo& router_info) const;
+    
+    // Индекс меток-хабов, если он построен и веса рёбер исходные, иначе nullptr
+    const graph::HubLabels<double>* GetActiveHubLabels() const;
+    
+    // Нижняя оценка времени в пути по расстоянию между остановками по прямой
+    graph::AStarRouter<double>::Heuristic MakeGeoHeuristic() const;
     
     const TransportCatalogue& db_;
     int bus_wait_time_;
     double bus_velocity_;
+    RouterMode router_mode_ = RouterMode::ALL_PAIRS;
+    size_t thread_count_ = 1;
+    bool compact_table_ = false;
+    size_t route_cache_size_ = 0;
+    std::map<std::string, RoutingProfile, std::less<>> profiles_;
+    bool use_hub_labels_ = false;
     std::unique_ptr<graph::DirectedWeightedGraph<double>> route_graph_;
-    std::unique_ptr<graph::Router<double>> graph_router_;
-    std::map<const Stop*, std::pair<int, int>> stop_to_vertexes_;
-    std::map<graph::EdgeId, Item> edge_to_item_;
+    std::unique_ptr<graph::RoutingEngine<double>> graph_router_;
+    std::unique_ptr<RaptorRouter> raptor_router_;
+    std::unique_ptr<RouteCache> route_cache_;
+    std::unique_ptr<graph::HubLabels<double>> hub_labels_;
+    graph::CsrGraph<double> frozen_graph_;
+    graph::GraphComponents components_;
+    // Остановка для каждой вершины ожидания, для остальных вершин — nullptr
+    std::vector<const Stop*> wait_vertex_stops_;
+    // Расстояние каждого ребра поездки по номеру ребра, для рёбер ожидания — 0
+    std::vector<double> edge_distances_;
+    // Закрытые остановки по номерам и множители времени автобусов по номерам; счётчики — сколько отличается от исходных
+    std::vector<bool> closed_stops_;
+    size_t closed_stop_count_ = 0;
+    std::vector<double> bus_time_factors_;
+    size_t changed_bus_count_ = 0;
+    // Текущие веса рёбер, +inf — ребро выключено; пусто — оперативных изменений нет
+    std::vector<double> live_weights_;
+    // Множитель времени каждого ребра для пересчёта весов по профилям
+    std::vector<double> edge_time_factors_;
+    std::vector<bool> changed_edges_;
+    size_t changed_edge_count_ = 0;
+    // Ни один вес не уменьшился: предвычисленный маршрут без изменённых рёбер остаётся кратчайшим
+    bool precomputed_valid_ = true;
+    graph::CsrGraph<double> live_graph_;
+    std::vector<std::pair<int, int>> stop_to_vertexes_;
+    std::vector<Item> edge_items_;
 };
+    
+template <typename TableWeight>
+void TransportRouter::RestoreRouter(graph::RoutesTable<TableWeight> routes_table) {
+    if (router_mode_ == RouterMode::STOP_PAIRS) {
+        graph_router_ = std::make_unique<graph::SubsetRouter<double, TableWeight>>(*route_graph_,
+                                                                                  GetWaitVertexes(),
+                                                                                  std::move(routes_table));
+    } else {
+        graph_router_ = std::make_unique<graph::Router<double, TableWeight>>(*route_graph_, std::move(routes_table));
+    }
+    ResetRouteCache();
+}
+    
+template <typename TableWeight>
+const graph::RoutesTable<TableWeight>* TransportRouter::GetRoutesTable() const {
+    if (const auto* router = dynamic_cast<const graph::Router<double, TableWeight>*>(graph_router_.get())) {
+        return &router->GetRoutesInternalData();
+    }
+    if (const auto* router = dynamic_cast<const graph::SubsetRouter<double, TableWeight>*>(graph_router_.get())) {
+        return &router->GetRoutesInternalData();
+    }
+    return nullptr;
+}
 } // namespace catalogue
\ No newline at end of file